@@ -0,0 +1,62 @@
+#include "bit_matrix.h"
+
+BIT_MATRIX *new_bit_matrix(int size)
+{
+    BIT_MATRIX *matrix = (BIT_MATRIX *)malloc(sizeof(BIT_MATRIX));
+
+    if (matrix == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    matrix->size = size;
+    matrix->words = (size + WORD_BITS - 1) / WORD_BITS;
+    /* One extra word, so an empty matrix still gets its own memory. */
+    matrix->bits = (unsigned long long *)calloc((size_t)size * matrix->words + 1,
+                                                sizeof(unsigned long long));
+
+    if (matrix->bits == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    return matrix;
+}
+
+void free_bit_matrix(BIT_MATRIX *matrix)
+{
+    free(matrix->bits);
+    free(matrix);
+}
+
+void or_row(unsigned long long *restrict target, const unsigned long long *restrict source,
+            int words)
+{
+    /* A plain loop over independent words, which the compiler turns into SIMD instructions. */
+    for (int w = 0; w < words; w++)
+    {
+        target[w] |= source[w];
+    }
+}
+
+void warshall_closure(BIT_MATRIX *matrix)
+{
+    for (int k = 0; k < matrix->size; k++)
+    {
+        unsigned long long *row_k = get_row(matrix, k);
+        unsigned long long mask = 1ULL << (k % WORD_BITS);
+        int word = k / WORD_BITS;
+
+        for (int i = 0; i < matrix->size; i++)
+        {
+            unsigned long long *row_i = get_row(matrix, i);
+
+            /* Row k only changes when it reaches itself, and then it gains nothing. */
+            if (i != k && (row_i[word] & mask) != 0)
+            {
+                or_row(row_i, row_k, matrix->words);
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef BIT_MATRIX_H
+#define BIT_MATRIX_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** @brief Number of bits in each word of a row. */
+#define WORD_BITS 64
+
+/** @brief Represents a square table of 0/1 values as bits.
+ *
+ *   Each row is an array of 64-bit words. Bit j of row i is bit j % 64 of word j / 64,
+ *   so a whole row can be combined with another one a word at a time.
+ */
+typedef struct
+{
+    int size;                 /* number of rows and columns */
+    int words;                /* number of words in each row */
+    unsigned long long *bits; /* the rows one after the other */
+} BIT_MATRIX;
+
+/** @brief Creates a bit matrix with all the bits set to 0.
+ *
+ *   @param size the number of rows and columns
+ *   @return the new bit matrix
+ */
+BIT_MATRIX *new_bit_matrix(int size);
+
+/** @brief Frees up the bit matrix from memory.
+ *
+ *   @param matrix the bit matrix
+ *   @return void
+ */
+void free_bit_matrix(BIT_MATRIX *matrix);
+
+/** @brief Gets the first word of a row.
+ *
+ *   @param matrix the bit matrix
+ *   @param row    the number of the row
+ *   @return the words of the row
+ */
+static inline unsigned long long *get_row(BIT_MATRIX *matrix, int row)
+{
+    return matrix->bits + (size_t)row * matrix->words;
+}
+
+/** @brief Sets a bit of the matrix to 1.
+ *
+ *   @param matrix the bit matrix
+ *   @param row    the row of the bit
+ *   @param column the column of the bit
+ *   @return void
+ */
+static inline void set_bit(BIT_MATRIX *matrix, int row, int column)
+{
+    get_row(matrix, row)[column / WORD_BITS] |= 1ULL << (column % WORD_BITS);
+}
+
+/** @brief Gets a bit of the matrix.
+ *
+ *   @param matrix the bit matrix
+ *   @param row    the row of the bit
+ *   @param column the column of the bit
+ *   @return 1 if the bit is set or 0 otherwise
+ */
+static inline int get_bit(BIT_MATRIX *matrix, int row, int column)
+{
+    return (int)((get_row(matrix, row)[column / WORD_BITS] >> (column % WORD_BITS)) & 1ULL);
+}
+
+/** @brief Adds all the bits of one row to another row.
+ *
+ *   @param target the row to add the bits to
+ *   @param source the row to add the bits from
+ *   @param words  the number of words in each row
+ *   @return void
+ */
+void or_row(unsigned long long *restrict target, const unsigned long long *restrict source,
+            int words);
+
+/** @brief Turns a table of links into its transitive closure with Warshall's algorithm.
+ *
+ *   For each city k, every row i that reaches k gets all the cities k reaches:
+ *   row[i] |= row[k]. The rows are combined a word at a time, 64 cities per operation.
+ *
+ *   @param matrix the table of links, replaced by the transitive closure
+ *   @return void
+ */
+void warshall_closure(BIT_MATRIX *matrix);
+
+#endif
@@ -0,0 +1,191 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+#include "blocked_closure.h"
+
+/** @brief Closes the pivot rows of a block between themselves, with Warshall's algorithm.
+ *
+ *   Afterwards each pivot row has every city its pivot reaches through the pivots of the
+ *   block and the ones before, so the other rows only need the pivot rows they reach.
+ *
+ *   @param matrix     the closure being built
+ *   @param pivot_word the word of the pivots of the block
+ *   @return void
+ */
+static void close_pivot_rows(BIT_MATRIX *matrix, int pivot_word)
+{
+    int first = pivot_word * WORD_BITS;
+    int end = (first + WORD_BITS < matrix->size) ? first + WORD_BITS : matrix->size;
+
+    for (int k = first; k < end; k++)
+    {
+        for (int i = first; i < end; i++)
+        {
+            /* Row k only changes when it reaches itself, and then it gains nothing. */
+            if (i != k && get_bit(matrix, i, k) == 1)
+            {
+                or_row(get_row(matrix, i), get_row(matrix, k), matrix->words);
+            }
+        }
+    }
+}
+
+/** @brief Builds the tables of the pivot rows for a tile of columns.
+ *
+ *   Row m of the table of group g is the OR of the pivot rows g * 8 + b for each bit b set
+ *   in m. Each row is one smaller row, m without its lowest bit, ORed with one pivot row.
+ *
+ *   @param w     the worker, with the tables to fill
+ *   @param tile  the first word of the columns
+ *   @param width the number of words of the columns, TILE_WORDS or less
+ *   @return void
+ */
+static void build_tables(BLOCK_WORKER *w, int tile, int width)
+{
+    int first_pivot = w->pivot_word * WORD_BITS;
+
+    for (int g = 0; g < GROUP_COUNT; g++)
+    {
+        unsigned long long *table = w->tables + (size_t)g * (1 << GROUP_BITS) * TILE_WORDS;
+
+        memset(table, 0, TILE_WORDS * sizeof(unsigned long long));
+        for (int m = 1; m < (1 << GROUP_BITS); m++)
+        {
+            int pivot = first_pivot + g * GROUP_BITS + __builtin_ctz((unsigned)m);
+            unsigned long long *entry = table + (size_t)m * TILE_WORDS;
+            unsigned long long *smaller = table + (size_t)(m & (m - 1)) * TILE_WORDS;
+            unsigned long long *pivot_row = NULL;
+
+            /* The last word of pivots can have fewer than 64 cities. */
+            if (pivot >= w->matrix->size)
+            {
+                memcpy(entry, smaller, (size_t)width * sizeof(unsigned long long));
+                continue;
+            }
+            pivot_row = get_row(w->matrix, pivot) + tile;
+            for (int word = 0; word < width; word++)
+            {
+                entry[word] = smaller[word] | pivot_row[word];
+            }
+        }
+    }
+}
+
+void blocked_closure(BIT_MATRIX *matrix, int thread_count)
+{
+    BLOCK_WORKER *workers = NULL;
+    pthread_t *threads = NULL;
+
+    if (thread_count <= 0)
+    {
+        thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    /* The tables are built again by each thread, so a thread needs enough rows to use them. */
+    if (thread_count > matrix->size / (1 << GROUP_BITS))
+    {
+        thread_count = matrix->size / (1 << GROUP_BITS);
+    }
+    if (thread_count < 1)
+    {
+        thread_count = 1;
+    }
+
+    workers = (BLOCK_WORKER *)malloc(thread_count * sizeof(BLOCK_WORKER));
+    threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    if (workers == NULL || threads == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i].matrix = matrix;
+        workers[i].first = (int)((long)matrix->size * i / thread_count);
+        workers[i].end = (int)((long)matrix->size * (i + 1) / thread_count);
+        workers[i].tables = (unsigned long long *)malloc((size_t)GROUP_COUNT *
+                                                         (1 << GROUP_BITS) * TILE_WORDS *
+                                                         sizeof(unsigned long long));
+        if (workers[i].tables == NULL)
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* The blocks are done in order, each one after all the rows have the ones before. */
+    for (int pivot_word = 0; pivot_word < matrix->words; pivot_word++)
+    {
+        close_pivot_rows(matrix, pivot_word);
+
+        for (int i = 0; i < thread_count; i++)
+        {
+            workers[i].pivot_word = pivot_word;
+        }
+        if (thread_count == 1)
+        {
+            block_worker(&workers[0]);
+            continue;
+        }
+        for (int i = 0; i < thread_count; i++)
+        {
+            if (pthread_create(&threads[i], NULL, block_worker, &workers[i]) != 0)
+            {
+                printf("Error: Could not create worker thread\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        for (int i = 0; i < thread_count; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        free(workers[i].tables);
+    }
+    free(workers);
+    free(threads);
+}
+
+void *block_worker(void *worker)
+{
+    BLOCK_WORKER *w = (BLOCK_WORKER *)worker;
+    BIT_MATRIX *matrix = w->matrix;
+    int first_pivot = w->pivot_word * WORD_BITS;
+
+    for (int tile = 0; tile < matrix->words; tile += TILE_WORDS)
+    {
+        int width = (matrix->words - tile < TILE_WORDS) ? matrix->words - tile : TILE_WORDS;
+
+        build_tables(w, tile, width);
+        for (int i = w->first; i < w->end; i++)
+        {
+            unsigned long long *row = get_row(matrix, i);
+            /*
+             * The pivot word can gain bits in the tile that has it, which changes nothing:
+             * a pivot reached through another pivot adds no city that pivot does not add.
+             */
+            unsigned long long pivots = row[w->pivot_word];
+
+            /* The pivot rows are already done. */
+            if (pivots == 0 || (i >= first_pivot && i < first_pivot + WORD_BITS))
+            {
+                continue;
+            }
+
+            for (int g = 0; g < GROUP_COUNT; g++)
+            {
+                int byte = (int)((pivots >> (g * GROUP_BITS)) & ((1 << GROUP_BITS) - 1));
+
+                if (byte != 0)
+                {
+                    or_row(row + tile, w->tables + ((size_t)g * (1 << GROUP_BITS) + byte) *
+                                                       TILE_WORDS, width);
+                }
+            }
+        }
+    }
+    return NULL;
+}
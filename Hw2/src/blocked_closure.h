@@ -0,0 +1,58 @@
+#ifndef BLOCKED_CLOSURE_H
+#define BLOCKED_CLOSURE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "bit_matrix.h"
+
+/** @brief Number of cities of each table of blocked_closure(), 2^8 = 256 rows per table. */
+#define GROUP_BITS 8
+
+/** @brief Number of tables of blocked_closure(), one for each group of a word of pivots. */
+#define GROUP_COUNT (WORD_BITS / GROUP_BITS)
+
+/** @brief Number of words of the columns the tables of a thread cover at a time.
+ *
+ *   GROUP_COUNT tables of 256 rows of TILE_WORDS words are 256 KB, which fit in L2.
+ */
+#define TILE_WORDS 16
+
+/** @brief What each thread of blocked_closure() needs. */
+typedef struct
+{
+    BIT_MATRIX *matrix;         /* the closure being built */
+    int pivot_word;             /* the word of the 64 pivot cities of the block */
+    int first;                  /* the first row of the thread */
+    int end;                    /* the row after the last one of the thread */
+    unsigned long long *tables; /* GROUP_COUNT tables of 256 rows of TILE_WORDS words */
+} BLOCK_WORKER;
+
+/** @brief Turns a table of links into its transitive closure with the Method of Four Russians.
+ *
+ *   Warshall's algorithm takes the pivot cities 64 at a time, a word of each row. The 64
+ *   pivot rows are first closed between themselves, like warshall_closure() would do. Every
+ *   other row then gets the pivot rows of the pivots it reaches. Instead of up to 64 rows,
+ *   it gets 8 rows of precomputed tables, one for each byte of its pivot word: the table of
+ *   a byte has the 256 combinations of the 8 pivot rows of that byte, ORed together. The
+ *   tables only cover TILE_WORDS words of columns at a time, so they stay in the L2 cache
+ *   while every row goes through them. The rows are split between threads.
+ *
+ *   The result is the same as with warshall_closure(), about 8 times less work for dense
+ *   tables.
+ *
+ *   @param matrix       the table of links, replaced by the transitive closure
+ *   @param thread_count the number of threads, or 0 to use one per processor
+ *   @return void
+ */
+void blocked_closure(BIT_MATRIX *matrix, int thread_count);
+
+/** @brief Thread that adds the pivot rows of a block to the other rows of its range.
+ *
+ *   @param worker the BLOCK_WORKER of the thread
+ *   @return NULL
+ */
+void *block_worker(void *worker);
+
+#endif
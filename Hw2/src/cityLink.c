@@ -2,26 +2,42 @@
 #include <stdlib.h>
 #include <string.h>
 #include <getopt.h>
-
-/** @brief Represents a city.
- *
- *   A city has a number assigned to it and points to the next city of the path.
- */
-typedef struct city
-{
-    int number;
-    struct city *next;
-} CITY;
+#include "bit_matrix.h"
+#include "graph.h"
+#include "search.h"
+#include "scc.h"
+#include "parallel_closure.h"
+#include "blocked_closure.h"
+#include "pair_set.h"
+#include "query.h"
+#include "labels.h"
+#include "index.h"
+#include "route.h"
+#include "dynamic_closure.h"
+#include "closure_writer.h"
+
+/** @brief Engines that can build the transitive closure, chosen with -e. */
+#define ENGINE_LIST 0     /* table of PATHs, each extending an earlier one */
+#define ENGINE_WARSHALL 1 /* bit matrix with Warshall's algorithm */
+#define ENGINE_SCC 2      /* bit matrix of the strongly connected components */
+#define ENGINE_BFS 3      /* bit matrix with a breadth-first search from each city, on threads */
+#define ENGINE_BLOCKED 4  /* bit matrix with Warshall's algorithm and the Four Russians' tables */
+
+/** @brief Ways -r can choose a path, chosen with -m. */
+#define ROUTE_HOPS 0     /* fewest links */
+#define ROUTE_DISTANCE 1 /* smallest total distance */
 
 /** @brief Represents a path from a starting city to an end city.
  *
- *  Has a size corresponding to the number of cities in the path and
- *  a pointer head to the first city of the path.
+ *  A path is a path of the table with one more city at the end, so only its first and
+ *  last city and the path it extends are kept, whatever its length. Its cities are only
+ *  listed when the path is printed, by following the paths it extends back to a link.
  */
 typedef struct
 {
-    int size;
-    CITY *head;
+    int start;    /* the first city of the path */
+    int end;      /* the last city of the path */
+    int previous; /* the index of the path it extends, or -1 if it is a link */
 } PATH;
 
 /** @brief Starts executing all the procedures of the program.
@@ -45,23 +61,136 @@ void start(int argc, char **argv);
  *   @param r_flag   flag possible path check
  *   @param p_flag   flag to print transitive closure
  *   @param o_flag   flag to print transitive closure in an output file
+ *   @param v_flag   flag to print the neighbor table read
  *   @param filename the file to read the cities from
  *   @param cities   the cities to find the transitive closure of
+ *   @param engine   the engine to build the transitive closure with
+ *   @param graph_filename the file to save the links in as a binary graph file, or NULL
+ *   @param thread_count   the number of threads of the engines and of the queries, 0 for
+ *                         one per processor
+ *   @param query_filename the file of queries to answer, "-" for the console, or NULL
+ *   @param build_index_filename the file to save the index of the cities in, or NULL
+ *   @param index_filename the index file to use instead of an input file, or NULL
+ *   @param route_mode     the way -r chooses a path
+ *   @param heuristic_filename the file of the coordinates of the cities for A*, or NULL
+ *   @param update_filename the file of changes to the links and queries, "-" for the console,
+ *                          or NULL
+ *   @param output_format  the format of the output file of -o
  *   @return void
  */
 void read_user_input(int argc, char **argv, int *i_flag, int *r_flag, int *p_flag, int *o_flag,
-                     char **filename, char **cities);
+                     int *v_flag, char **filename, char **cities, int *engine,
+                     char **graph_filename, int *thread_count, char **query_filename,
+                     char **build_index_filename, char **index_filename, int *route_mode,
+                     char **heuristic_filename, char **update_filename, int *output_format);
+
+/** @brief Runs the chosen procedures with the table of PATHs.
+ *
+ *   The path printed by -r is the one of the table.
+ *
+ *   @param graph    the links between the cities
+ *   @param r_flag   flag possible path check
+ *   @param p_flag   flag to print transitive closure
+ *   @param o_flag   flag to print transitive closure in an output file
+ *   @param cities   the cities to check for a path
+ *   @param filename the name of the input file
+ *   @param output_format the format of the output file
+ *   @return void
+ */
+void run_list_engine(GRAPH *graph, int r_flag, int p_flag, int o_flag, char *cities,
+                     char *filename, int output_format);
+
+/** @brief Runs the chosen procedures with the transitive closure as a bit matrix.
+ *
+ *   @param graph        the links between the cities
+ *   @param r_flag       flag possible path check
+ *   @param p_flag       flag to print transitive closure
+ *   @param o_flag       flag to print transitive closure in an output file
+ *   @param cities       the cities to check for a path
+ *   @param filename     the name of the input file
+ *   @param engine       ENGINE_WARSHALL, ENGINE_BFS or ENGINE_BLOCKED, to build the bit
+ *                       matrix with
+ *   @param thread_count the number of threads of the bfs and blocked engines, 0 for one per
+ *                       processor
+ *   @param output_format the format of the output file
+ *   @return void
+ */
+void run_matrix_engine(GRAPH *graph, int r_flag, int p_flag, int o_flag, char *cities,
+                       char *filename, int engine, int thread_count, int output_format);
+
+/** @brief Runs the chosen procedures with the transitive closure of the strongly connected
+ *   components.
+ *
+ *   @param graph    the links between the cities
+ *   @param r_flag   flag possible path check
+ *   @param p_flag   flag to print transitive closure
+ *   @param o_flag   flag to print transitive closure in an output file
+ *   @param cities   the cities to check for a path
+ *   @param filename the name of the input file
+ *   @param output_format the format of the output file
+ *   @return void
+ */
+void run_scc_engine(GRAPH *graph, int r_flag, int p_flag, int o_flag, char *cities,
+                    char *filename, int output_format);
 
-/** @brief Reads the cities from specified input file.
+/** @brief Runs the chosen procedures with an index file built by --build-index.
  *
- *   Saves the input in a table and prints it in the console.
+ *   Nothing is computed again: -r and -q search the links of the index for the paths the
+ *   closure or the labels of the index say exist, and -p and -o print the transitive closure
+ *   of the strongly connected components, if the index has it.
  *
- *   @param filename       the file to read the cities from
- *   @param N              the size of the table
- *   @param neighbor_table the table to save the input from the file
+ *   @param index_filename the name of the index file
+ *   @param r_flag         flag possible path check
+ *   @param p_flag         flag to print transitive closure
+ *   @param o_flag         flag to print transitive closure in an output file
+ *   @param cities         the cities to check for a path
+ *   @param query_filename the file of queries to answer, "-" for the console, or NULL
+ *   @param thread_count   the number of threads of the queries, 0 for one per processor
+ *   @param route_mode     the way -r chooses a path
+ *   @param heuristic_filename the file of the coordinates of the cities for A*, or NULL
+ *   @param update_filename the file of changes to the links and queries, "-" for the console,
+ *                          or NULL
+ *   @param output_format  the format of the output file
  *   @return void
  */
-void read_neighbor_table(char *filename, int *N, int ***neighbor_table);
+void run_index(char *index_filename, int r_flag, int p_flag, int o_flag, char *cities,
+               char *query_filename, int thread_count, int route_mode,
+               char *heuristic_filename, char *update_filename, int output_format);
+
+/** @brief Prints how to run the program.
+ *
+ *   @return void
+ */
+void print_usage(void);
+
+/** @brief Checks for a path between the cities given with -r.
+ *
+ *   The shortest path is found with find_path(), straight from the links, so the transitive
+ *   closure is not needed. If the components are given, their closure or their labels tell
+ *   first whether the path exists, so a missing path is not searched for.
+ *
+ *   @param graph        the links between the cities
+ *   @param reverse      the links reversed, or NULL to build them here
+ *   @param condensation the components, or NULL to always search
+ *   @param labels       the labels of the components if they have no transitive closure
+ *   @param cities       the cities to check for a path
+ *   @return void
+ */
+void check_for_path(GRAPH *graph, GRAPH *reverse, CONDENSATION *condensation, LABELS *labels,
+                    char *cities);
+
+/** @brief Checks for the route with the smallest total distance between the cities given
+ *   with -r.
+ *
+ *   The route is found with find_route(), with A* if coordinates are given, and printed like
+ *   a path, followed by its distance.
+ *
+ *   @param graph              the links between the cities, with their distances
+ *   @param cities             the cities to check for a route
+ *   @param heuristic_filename the file of the coordinates of the cities, or NULL
+ *   @return void
+ */
+void check_for_route(GRAPH *graph, char *cities, char *heuristic_filename);
 
 /** @brief Gets the starting and ending city from the input string.
  *
@@ -77,72 +206,88 @@ void get_cities(char *cities, int *start_city, int *end_city);
 
 /** @brief Initializes the transitive closure table.
  *
- *   Uses the neighbor table for the initialization.
+ *   Uses the links between the cities for the initialization.
  *
  *   @param transitive_closure the transitive closure table to initialize
  *   @param tc_size            the size of the transitive closure table
- *   @param neighbor_table     the table to use for the initialization
- *   @param N                  the size of the neighbor table
+ *   @param graph              the links to use for the initialization
+ *   @param pairs              the starting and ending cities of the paths in the table,
+ *                             with their index if the set keeps values
  *   @return void
  */
-void init_transitive_closure(PATH **transitive_closure, int *tc_size, int **neighbor_table, int N);
+void init_transitive_closure(PATH **transitive_closure, int *tc_size, GRAPH *graph,
+                             PAIR_SET *pairs);
 
-/** @brief Inserts a new city in the specified Path of cities.
+/** @brief Adds a new Path at the end of the transitive closure table.
  *
- *   The new city has the specified city_number. If the city is the first of the path, the city
- *   becomes the head of the path.
+ *   The table grows to twice its size when it is full, which is when its size is a power of 2.
  *
- *   @param path        the path of cities
- *   @param city_number the number of the new city
+ *   @param transitive_closure the transitive closure table
+ *   @param tc_size            the size of the transitive closure table
+ *   @param start              the first city of the new path
+ *   @param end                the last city of the new path
+ *   @param previous           the index of the path the new one extends, or -1 for a link
  *   @return void
  */
-void insert_city(PATH *path, int city_number);
+void add_path(PATH **transitive_closure, int *tc_size, int start, int end, int previous);
 
 /** @brief Builds the transitive closure table.
  *
  *   Goes through all the existing Paths in the transitive closure table and
- *   builds new by comparing them to the ones in neighbor table.
+ *   builds new by extending them with the links of their last city.
  *
  *   @param transitive_closure the transitive closure table to build
  *   @param tc_size            the size of the transitive closure table
- *   @param neighbor_table     the table to compare the existing paths
- *   @param N                  the size of the neighbor table
+ *   @param graph              the links to extend the existing paths with
+ *   @param pairs              the starting and ending cities of the paths in the table,
+ *                             with their index if the set keeps values
  *   @return void
  */
-void build_transitive_closure(PATH **transitive_closure, int *tc_size, int **neighbor_table, int N);
+void build_transitive_closure(PATH **transitive_closure, int *tc_size, GRAPH *graph,
+                              PAIR_SET *pairs);
 
 /** @brief Checks for repetition of paths in the transitive closure table.
  *
- *   Compares the specified starting and ending cities with the starting and ending cities 
- *   for each path in the transitive closure table.
+ *   Looks the specified starting and ending cities up in the set of the starting and ending
+ *   cities of the paths in the transitive closure table, in constant time.
  *  
- *   @param start              the starting city
- *   @param end                the ending city
- *   @param transitive_closure the transitive closure table to build
- *   @param tc_size            the size of the transitive closure table
+ *   @param start the starting city
+ *   @param end   the ending city
+ *   @param pairs the starting and ending cities of the paths in the table
  *   @return 1 if path already exists or 0 otherwise
  */
-int check_repetition(int start, int end, PATH *transitive_closure, int tc_size);
+int check_repetition(int start, int end, PAIR_SET *pairs);
 
-/** @brief Copies the old path to the new path.
- *   
- *   Inserts each city one by one.
- *  
- *   @param new_path the new path
- *   @param old_path the old path to copy
+/** @brief Lists the cities of a path of the transitive closure table.
+ *
+ *   @param transitive_closure the transitive closure table
+ *   @param index              the index of the path
+ *   @param path               room for the cities of the path
+ *   @return the number of cities of the path
+ */
+int get_path(PATH *transitive_closure, int index, int *path);
+
+/** @brief Checks for a path between the cities given with -r in the transitive closure table.
+ *
+ *   The index of the path in the table is looked up in the set of pairs in constant time.
+ *
+ *   @param transitive_closure the transitive closure table
+ *   @param city_count         the number of cities
+ *   @param pairs              the starting and ending cities of the paths in the table,
+ *                             with their index if the set keeps values
+ *   @param cities             the cities to check for a path
  *   @return void
  */
-void copy_path(PATH *new_path, PATH old_path);
+void check_for_listed_path(PATH *transitive_closure, int city_count, PAIR_SET *pairs,
+                           char *cities);
 
-/** @brief Checks the transitive closure table for possible path between specified cities.
- * 
- *   @param transitive_closure the transitive closure table 
- *   @param tc_size            the size of the transitive closure table 
- *   @param start_city         the starting city for the path to check
- *   @param end_city           the ending city for the path to check
+/** @brief Prints whether a path exists and its cities.
+ *
+ *   @param path   the cities of the path
+ *   @param length the number of cities of the path, 0 if there is no path
  *   @return void
  */
-void check_for_path(PATH *transitive_closure, int tc_size, int start_city, int end_city);
+void print_path(int *path, int length);
 
 /** @brief Prints the transitive closure table.
  *
@@ -152,102 +297,335 @@ void check_for_path(PATH *transitive_closure, int tc_size, int start_city, int e
  */
 void print_transitive_closure(PATH *transitive_closure, int tc_size);
 
-/** @brief Prints the successful path.
- *
- *   @param transitive_closure the transitive closure table to get the path from
- *   @param index              the index of the successful path
- *   @return void
- */
-void print_successful_path(PATH *transitive_closure, int index);
-
 /** @brief Saves the transitive closure table in an output file.
  * 
- *   Output file name uses input file name.
+ *   Output file name uses input file name. The text format lists the paths in the order of
+ *   the table, the other formats by starting city and then by ending city.
  *
  *   @param transitive_closure the transitive closure table to save
  *   @param tc_size            the size of the transitive closure table
+ *   @param city_count         the number of cities
  *   @param filename           the name of the input file
+ *   @param format             the format of the output file
  *   @return void
  */
-void save_transitive_closure(PATH *transitive_closure, int tc_size, char* filename);
+void save_transitive_closure(PATH *transitive_closure, int tc_size, int city_count,
+                             char *filename, int format);
+
+/** @brief Builds the bit matrix of the links between the cities.
+ *
+ *   Self-references are ignored, like in init_transitive_closure().
+ *
+ *   @param graph the links between the cities
+ *   @return the bit matrix with a bit set for each link
+ */
+BIT_MATRIX *build_link_matrix(GRAPH *graph);
+
+/** @brief Prints the transitive closure bit matrix.
+ *
+ *   Pairs are printed by starting city and then by ending city.
+ *
+ *   @param fp      the file to print to
+ *   @param closure the transitive closure bit matrix
+ *   @param format  the format to print in
+ *   @return void
+ */
+void print_closure_matrix(FILE *fp, BIT_MATRIX *closure, int format);
+
+/** @brief Saves the transitive closure bit matrix in an output file.
+ *
+ *   Output file name uses input file name, like save_transitive_closure().
+ *
+ *   @param closure  the transitive closure bit matrix
+ *   @param filename the name of the input file
+ *   @param format   the format of the output file
+ *   @return void
+ */
+void save_closure_matrix(BIT_MATRIX *closure, char *filename, int format);
+
+/** @brief Prints the transitive closure of the strongly connected components, city by city.
+ *
+ *   Pairs are printed by starting city and then by ending city, like print_closure_matrix().
+ *
+ *   @param fp           the file to print to
+ *   @param condensation the components, with their transitive closure built
+ *   @param format       the format to print in
+ *   @return void
+ */
+void print_condensed_closure(FILE *fp, CONDENSATION *condensation, int format);
+
+/** @brief Saves the transitive closure of the strongly connected components in an output file.
+ *
+ *   @param condensation the components, with their transitive closure built
+ *   @param filename     the name of the input file
+ *   @param format       the format of the output file
+ *   @return void
+ */
+void save_condensed_closure(CONDENSATION *condensation, char *filename, int format);
+
+/** @brief Creates the output file for the transitive closure.
+ *
+ *   Output file name uses input file name, like save_transitive_closure().
+ *
+ *   @param filename the name of the input file
+ *   @return the output file, to be closed by the caller
+ */
+FILE *open_output_file(char *filename);
 
 /************************** Function definitions **************************/
 
 void start(int argc, char **argv)
 {
-    int i_flag = 0, r_flag = 0, p_flag = 0, o_flag = 0; /* options the user chooses */
+    int i_flag = 0, r_flag = 0, p_flag = 0, o_flag = 0, v_flag = 0; /* options the user chooses */
+    int engine = ENGINE_WARSHALL;
+    int thread_count = 0; /* threads of the engines and the queries, 0 for one per processor */
     char *filename = NULL;
     char *cities = NULL;
-    int **neighbor_table = NULL;
-    int N; /* the size of the neighbor table */
-    int start_city, end_city;
+    char *graph_filename = NULL;
+    char *query_filename = NULL;
+    char *build_index_filename = NULL;
+    char *index_filename = NULL;
+    int route_mode = ROUTE_HOPS;
+    char *heuristic_filename = NULL;
+    char *update_filename = NULL;
+    int output_format = FORMAT_TEXT;
+    GRAPH *graph = NULL; /* the links between the cities */
+
+    read_user_input(argc, argv, &i_flag, &r_flag, &p_flag, &o_flag, &v_flag, &filename, &cities,
+                    &engine, &graph_filename, &thread_count, &query_filename,
+                    &build_index_filename, &index_filename, &route_mode, &heuristic_filename,
+                    &update_filename, &output_format);
+
+    /* An index already has everything the procedures need. */
+    if (index_filename != NULL)
+    {
+        run_index(index_filename, r_flag, p_flag, o_flag, cities, query_filename, thread_count,
+                  route_mode, heuristic_filename, update_filename, output_format);
+        return;
+    }
+
+    graph = read_graph(filename, v_flag);
+
+    if (graph_filename != NULL)
+    {
+        save_binary_graph(graph, graph_filename);
+    }
+
+    if (build_index_filename != NULL)
+    {
+        save_index(graph, build_index_filename);
+    }
+
+    /* A route by distance is searched for straight from the links, before any closure. */
+    if (r_flag == 1 && route_mode == ROUTE_DISTANCE)
+    {
+        check_for_route(graph, cities, heuristic_filename);
+        r_flag = 0;
+    }
 
+    /* A path check alone does not need the transitive closure. */
+    if (p_flag == 0 && o_flag == 0)
+    {
+        if (r_flag == 1)
+        {
+            check_for_path(graph, NULL, NULL, NULL, cities);
+        }
+    }
+    else if (engine == ENGINE_LIST)
+    {
+        run_list_engine(graph, r_flag, p_flag, o_flag, cities, filename, output_format);
+    }
+    else if (engine == ENGINE_SCC)
+    {
+        run_scc_engine(graph, r_flag, p_flag, o_flag, cities, filename, output_format);
+    }
+    else
+    {
+        run_matrix_engine(graph, r_flag, p_flag, o_flag, cities, filename, engine, thread_count,
+                          output_format);
+    }
+
+    if (query_filename != NULL)
+    {
+        answer_queries(graph, NULL, NULL, NULL, query_filename, thread_count);
+    }
+
+    if (update_filename != NULL)
+    {
+        answer_updates(graph, update_filename, thread_count);
+    }
+    free_graph(graph);
+}
+
+void run_list_engine(GRAPH *graph, int r_flag, int p_flag, int o_flag, char *cities,
+                     char *filename, int output_format)
+{
     /* Transitive closure is a 1D array of Paths between cities. */
     PATH *transitive_closure = NULL;
     int tc_size = 0; /* size of transitive closure array */
+    /* The cities of the paths in the table, with the index of the path if -r looks one up. */
+    PAIR_SET *pairs = new_pair_set(graph->city_count, r_flag);
 
-    read_user_input(argc, argv, &i_flag, &r_flag, &p_flag, &o_flag, &filename, &cities);
-    read_neighbor_table(filename, &N, &neighbor_table);
-
-    init_transitive_closure(&transitive_closure, &tc_size, neighbor_table, N);
-    build_transitive_closure(&transitive_closure, &tc_size, neighbor_table, N);
+    init_transitive_closure(&transitive_closure, &tc_size, graph, pairs);
+    build_transitive_closure(&transitive_closure, &tc_size, graph, pairs);
 
     if (p_flag == 1)
     {
         print_transitive_closure(transitive_closure, tc_size);
     }
 
-    for (int i = 0; i < N; i++)
+    if (r_flag == 1)
     {
-        free((neighbor_table)[i]);
+        check_for_listed_path(transitive_closure, graph->city_count, pairs, cities);
     }    
-    free(neighbor_table);
+    free_pair_set(pairs);
+
+    if (o_flag == 1)
+    {
+        save_transitive_closure(transitive_closure, tc_size, graph->city_count, filename,
+                                output_format);
+    }
+    free(transitive_closure);      
+}
+
+void run_matrix_engine(GRAPH *graph, int r_flag, int p_flag, int o_flag, char *cities,
+                       char *filename, int engine, int thread_count, int output_format)
+{
+    BIT_MATRIX *closure = NULL;
+
+    if (engine == ENGINE_BFS)
+    {
+        closure = bfs_closure(graph, thread_count);
+    }
+    else if (engine == ENGINE_BLOCKED)
+    {
+        closure = build_link_matrix(graph);
+        blocked_closure(closure, thread_count);
+    }
+    else
+    {
+        closure = build_link_matrix(graph);
+        warshall_closure(closure);
+    }
+
+    if (p_flag == 1)
+    {
+        print_closure_matrix(stdout, closure, FORMAT_TEXT);
+    }
 
     if (r_flag == 1)
     {
-        get_cities(cities, &start_city, &end_city);        
-        check_for_path(transitive_closure, tc_size, start_city, end_city);
-    }    
+        check_for_path(graph, NULL, NULL, NULL, cities);
+    }
+
+    if (o_flag == 1)
+    {
+        save_closure_matrix(closure, filename, output_format);
+    }
+    free_bit_matrix(closure);
+}
+
+void run_scc_engine(GRAPH *graph, int r_flag, int p_flag, int o_flag, char *cities,
+                    char *filename, int output_format)
+{
+    CONDENSATION *condensation = condense_graph(graph);
+
+    build_condensed_closure(condensation, graph);
+
+    if (p_flag == 1)
+    {
+        print_condensed_closure(stdout, condensation, FORMAT_TEXT);
+    }
+
+    if (r_flag == 1)
+    {
+        check_for_path(graph, NULL, condensation, NULL, cities);
+    }
 
     if (o_flag == 1)
     {
-        save_transitive_closure(transitive_closure, tc_size, filename);
+        save_condensed_closure(condensation, filename, output_format);
     }
+    free_condensation(condensation);
+}
 
-    /* Goes through all the cities in the transitive closure table and frees them from memory. */
-    for (int i = 0; i < tc_size; i++)
+void run_index(char *index_filename, int r_flag, int p_flag, int o_flag, char *cities,
+               char *query_filename, int thread_count, int route_mode,
+               char *heuristic_filename, char *update_filename, int output_format)
+{
+    INDEX *index = open_index(index_filename);
+
+    /* The labels only answer one pair at a time. */
+    if ((p_flag == 1 || o_flag == 1) && index->condensation->reach == NULL)
     {
-        CITY *q = transitive_closure[i].head;
-        CITY *tmp = NULL; /* to save the current city, in order to free it */
+        printf("The index has too many components for their transitive closure, "
+               "only -r and -q can be used!\n");
+        exit(EXIT_FAILURE);
+    }
 
-        while (q->next != NULL)
-        {
-            free(tmp);
-            tmp = q;
-            q = q->next;            
-        }
-        free(tmp);
+    if (p_flag == 1)
+    {
+        print_condensed_closure(stdout, index->condensation, FORMAT_TEXT);
     }
-    free(transitive_closure);      
+
+    if (r_flag == 1 && route_mode == ROUTE_DISTANCE)
+    {
+        check_for_route(index->graph, cities, heuristic_filename);
+    }
+    else if (r_flag == 1)
+    {
+        check_for_path(index->graph, index->reverse, index->condensation, index->labels, cities);
+    }
+
+    /* The output file name uses the index file name. */
+    if (o_flag == 1)
+    {
+        save_condensed_closure(index->condensation, index_filename, output_format);
+    }
+
+    if (query_filename != NULL)
+    {
+        answer_queries(index->graph, index->reverse, index->condensation, index->labels,
+                       query_filename, thread_count);
+    }
+
+    /* The changes are made to a copy of the links, the index file stays as it is. */
+    if (update_filename != NULL)
+    {
+        answer_updates(index->graph, update_filename, thread_count);
+    }
+    close_index(index);
 }
 
 void read_user_input(int argc, char **argv, int *i_flag, int *r_flag, int *p_flag, int *o_flag,
-                     char **filename, char **cities)
+                     int *v_flag, char **filename, char **cities, int *engine,
+                     char **graph_filename, int *thread_count, char **query_filename,
+                     char **build_index_filename, char **index_filename, int *route_mode,
+                     char **heuristic_filename, char **update_filename, int *output_format)
 {
     int option; /* to save the command line options */
+    /* Options that only have a long name. Each one is returned as the character next to it. */
+    struct option long_options[] = {
+        {"build-index", required_argument, NULL, 'b'},
+        {"index", required_argument, NULL, 'x'},
+        {"heuristic", required_argument, NULL, 'a'},
+        {"format", required_argument, NULL, 'f'},
+        {NULL, 0, NULL, 0}
+    };
 
     /* If argc == 1(the program name), then no arguments have been given. */
     if (argc == 1)
     {
         printf("No command line arguments given!\n");
-        printf("Usage: <executable> -i <inputfile> [-r <source >,<destination> -p -o]\n");
+        print_usage();
         exit(EXIT_FAILURE);
     }
 
     /*
-     * Scans the command line arguments and searches for options 'i', 'r', 'p' and 'o'.
+     * Scans the command line arguments and searches for options 'i', 'r', 'p', 'o', 'v', 'e',
+     * 's', 'j', 'q', 'm', 'u', "build-index", "index", "heuristic" and "format".
      */
-    while ((option = getopt(argc, argv, "i:r:po")) != -1)
+    while ((option = getopt_long(argc, argv, "i:r:pove:s:j:q:m:u:", long_options, NULL)) != -1)
     {
         switch (option)
         {
@@ -266,6 +644,102 @@ void read_user_input(int argc, char **argv, int *i_flag, int *r_flag, int *p_fla
         case (int)'o':
             *o_flag = 1;
             break;
+        case (int)'v':
+            *v_flag = 1;
+            break;
+        case (int)'e':
+            if (strcmp(optarg, "list") == 0)
+            {
+                *engine = ENGINE_LIST;
+            }
+            else if (strcmp(optarg, "warshall") == 0)
+            {
+                *engine = ENGINE_WARSHALL;
+            }
+            else if (strcmp(optarg, "scc") == 0)
+            {
+                *engine = ENGINE_SCC;
+            }
+            else if (strcmp(optarg, "bfs") == 0)
+            {
+                *engine = ENGINE_BFS;
+            }
+            else if (strcmp(optarg, "blocked") == 0)
+            {
+                *engine = ENGINE_BLOCKED;
+            }
+            else
+            {
+                printf("Unknown engine \"%s\"\n", optarg);
+                printf("Engines: list, warshall, scc, bfs, blocked\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case (int)'s':
+            *graph_filename = optarg;
+            break;
+        case (int)'j':
+            /* Only digits, like the numbers of -r, and few enough to fit in an int. */
+            if (*optarg == '\0' || strspn(optarg, "0123456789") != strlen(optarg) ||
+                strlen(optarg) > 4)
+            {
+                printf("Invalid threads argument\n");
+                printf("Threads format: -j number, from 0 (one per processor) to 9999\n");
+                exit(EXIT_FAILURE);
+            }
+            *thread_count = atoi(optarg);
+            break;
+        case (int)'q':
+            *query_filename = optarg;
+            break;
+        case (int)'b':
+            *build_index_filename = optarg;
+            break;
+        case (int)'x':
+            *index_filename = optarg;
+            break;
+        case (int)'m':
+            if (strcmp(optarg, "hops") == 0)
+            {
+                *route_mode = ROUTE_HOPS;
+            }
+            else if (strcmp(optarg, "distance") == 0)
+            {
+                *route_mode = ROUTE_DISTANCE;
+            }
+            else
+            {
+                printf("Unknown route mode \"%s\"\n", optarg);
+                printf("Route modes: hops, distance\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case (int)'a':
+            *heuristic_filename = optarg;
+            break;
+        case (int)'u':
+            *update_filename = optarg;
+            break;
+        case (int)'f':
+            if (strcmp(optarg, "text") == 0)
+            {
+                *output_format = FORMAT_TEXT;
+            }
+            else if (strcmp(optarg, "bits") == 0)
+            {
+                *output_format = FORMAT_BITS;
+            }
+            else if (strcmp(optarg, "csr") == 0)
+            {
+                *output_format = FORMAT_CSR;
+            }
+            else
+            {
+                printf("Unknown output format \"%s\"\n", optarg);
+                printf("Output formats: text, bits, csr\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
 
         /* Case when an unrecognized option is given or there is a missing argument. */
         case (int)'?':
@@ -273,74 +747,104 @@ void read_user_input(int argc, char **argv, int *i_flag, int *r_flag, int *p_fla
              * Case '?' means there is an error with arguments, therefore the program
              * needs to be terminated.
              */
-            printf("Usage: <executable> -i <inputfile> [-r <source >,<destination> -p -o]\n");
+            print_usage();
             exit(EXIT_FAILURE);
         }
     }
-    /* Checks whether the input file has been provided. */
-    if (*i_flag == 0)
+    /* Checks whether the input file has been provided. An index file replaces it. */
+    if (*i_flag == 0 && *index_filename == NULL)
     {
         printf("No input file given!\n");
         exit(EXIT_FAILURE);
     }
+    /* The coordinates only guide a search by distance. */
+    if (*heuristic_filename != NULL)
+    {
+        *route_mode = ROUTE_DISTANCE;
+    }
 }
 
-void read_neighbor_table(char *filename, int *N, int ***neighbor_table)
+void print_usage(void)
 {
-    FILE *fp;
+    printf("Usage: <executable> -i <inputfile> [-r <source >,<destination> -p -o -v]\n");
+    printf("       [-e list|warshall|scc|bfs|blocked -j <threads> -s <graphfile>]\n");
+    printf("       [-q <queryfile> -u <updatefile> --format text|bits|csr]\n");
+    printf("       [-m hops|distance --heuristic <coordinatefile> --build-index <indexfile>]\n");
+    printf("   or: <executable> --index <indexfile> [-r <source >,<destination> -p -o]\n");
+    printf("       [-j <threads> -q <queryfile> -m hops|distance --heuristic <coordinatefile>]\n");
+    printf("       [-u <updatefile> --format text|bits|csr]\n");
+}
+
+void check_for_path(GRAPH *graph, GRAPH *reverse, CONDENSATION *condensation, LABELS *labels,
+                    char *cities)
+{
+    int start_city, end_city, length;
+    int own_reverse = (reverse == NULL);
+    int *path = (int *)malloc(((size_t)graph->city_count + 1) * sizeof(int));
+    SEARCH *search = NULL;
 
-    if ((fp = fopen(filename, "r")) == NULL)
+    if (own_reverse)
     {
-        printf("Input file cannot be read!\n");
-        exit(EXIT_FAILURE);
+        reverse = reverse_graph(graph);
     }
+    search = new_search(graph, reverse);
 
-    /* Reads N from input file. */
-    fscanf(fp, "%d", N);
-
-    /* Reserves space for N pointers that point to integer pointers. */
-    *neighbor_table = (int **)malloc(*N * sizeof(int *));
-
-    if (*neighbor_table == NULL)
+    if (path == NULL)
     {
         printf("Error: Could not allocate memory\n");
         exit(EXIT_FAILURE);
     }
 
-    /* For each pointer i reserves space for N integers. */
-    for (int i = 0; i < *N; i++)
+    get_cities(cities, &start_city, &end_city);
+    /* Cities out of range are left to find_path(), which finds no path for them. */
+    if (condensation != NULL && start_city >= 0 && start_city < graph->city_count &&
+        end_city >= 0 && end_city < graph->city_count &&
+        !(condensation->reach != NULL ? reaches(condensation, start_city, end_city)
+                                      : labels_reach(labels, condensation, start_city, end_city)))
     {
-        (*neighbor_table)[i] = (int *)malloc(*N * sizeof(int));
-
-        if ((*neighbor_table)[i] == NULL)
-        {
-            printf("Error: Could not allocate memory\n");
-            exit(EXIT_FAILURE);
-        }
+        length = 0;
+    }
+    else
+    {
+        length = find_path(search, start_city, end_city, path);
     }
+    print_path(path, length);
 
-    /* Reads the input file and saves the values in the neighbor_table. */
-    for (int i = 0; i < *N; i++)
+    free_search(search);
+    if (own_reverse)
     {
-        for (int j = 0; j < *N; j++)
-        {
-            fscanf(fp, "%d", &((*neighbor_table)[i][j]));
-        }
+        free_graph(reverse);
     }
-    fclose(fp);
+    free(path);
+}
 
-    printf("Neighbor table\n");
+void check_for_route(GRAPH *graph, char *cities, char *heuristic_filename)
+{
+    int start_city, end_city, length;
+    int *path = (int *)malloc(((size_t)graph->city_count + 1) * sizeof(int));
+    double *coordinates = NULL;
+    long long distance;
 
-    /* Prints the neighbor_table. */
-    for (int i = 0; i < *N; i++)
+    if (path == NULL)
     {
-        for (int j = 0; j < *N; j++)
-        {
-            printf("%d ", (*neighbor_table)[i][j]);
-        }
-        printf("\n");
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
     }
-    printf("\n");
+    if (heuristic_filename != NULL)
+    {
+        coordinates = read_coordinates(heuristic_filename, graph->city_count);
+    }
+
+    get_cities(cities, &start_city, &end_city);
+    distance = find_route(graph, coordinates, start_city, end_city, path, &length);
+    print_path(path, length);
+    if (length > 0)
+    {
+        printf("Distance: %lld\n", distance);
+    }
+
+    free(coordinates);
+    free(path);
 }
 
 void get_cities(char *cities, int *start_city, int *end_city)
@@ -432,261 +936,259 @@ void get_cities(char *cities, int *start_city, int *end_city)
     free(end_city_str);
 }
 
-void init_transitive_closure(PATH **transitive_closure, int *tc_size, int **neighbor_table, int N)
+void init_transitive_closure(PATH **transitive_closure, int *tc_size, GRAPH *graph,
+                             PAIR_SET *pairs)
 {
-    /* Initialize table with malloc, so realloc can be used later. */
-    *transitive_closure = (PATH *)malloc(sizeof(PATH));
-
-    if (*transitive_closure == NULL)
-    {
-        printf("Error: Could not allocate memory\n");
-        exit(EXIT_FAILURE);
-    }
-
-    for (int i = 0; i < N; i++)
+    for (int i = 0; i < graph->city_count; i++)
     {
-        for (int j = 0; j < N; j++)
+        /* Each link of city i, in increasing order of the city j it connects with. */
+        for (long link = graph->offsets[i]; link < graph->offsets[i + 1]; link++)
         {
+            int j = graph->targets[link];
+
             /* Ignore self-references. */
             if (i == j)
             {
                 continue;
             }
-            /* If a value in the table is 1, then city i connects with city j. */
-            if (neighbor_table[i][j] == 1)
-            {
-                (*tc_size)++;
 
-                /* Increase the transitive closure array to new size. */
-                PATH *tmp = (PATH *)realloc(*transitive_closure, (*tc_size) * sizeof(PATH));
+            add_path(transitive_closure, tc_size, i, j, -1);
+            add_pair(pairs, i, j, *tc_size - 1);
+        }
+    }
+}
+
+void add_path(PATH **transitive_closure, int *tc_size, int start, int end, int previous)
+{
+    /* A full table has a size of 0 or a power of 2. */
+    if ((*tc_size & (*tc_size - 1)) == 0)
+    {
+        size_t capacity = (*tc_size == 0) ? 1 : 2 * (size_t)*tc_size;
+        PATH *tmp = (PATH *)realloc(*transitive_closure, capacity * sizeof(PATH));
 
-                if (tmp == NULL)
-                {
-                    printf("Error: Unable to Allocate Memory using realloc\n");
-                    exit(EXIT_FAILURE);
-                }
+        if (tmp == NULL)
+        {
+            printf("Error: Unable to Allocate Memory using realloc\n");
+            exit(EXIT_FAILURE);
+        }
+        *transitive_closure = tmp;
+    }
+
+    (*transitive_closure)[*tc_size].start = start;
+    (*transitive_closure)[*tc_size].end = end;
+    (*transitive_closure)[*tc_size].previous = previous;
+    (*tc_size)++;
+}
 
-                *transitive_closure = tmp;
+void build_transitive_closure(PATH **transitive_closure, int *tc_size, GRAPH *graph,
+                              PAIR_SET *pairs)
+{
+    /* Iterates through the transitive closure table. */
+    for (int i = 0; i < *tc_size; i++)
+    {        
+        int start = (*transitive_closure)[i].start; /* the first city of the current path */
+        int end = (*transitive_closure)[i].end;     /* the last city of the current path */
 
-                /* Initial values for Paths. */
-                (*transitive_closure)[*tc_size - 1].head = NULL;
-                (*transitive_closure)[*tc_size - 1].size = 0;
+        /* Iterates through the links of the last city of the current path. */
+        for (long link = graph->offsets[end]; link < graph->offsets[end + 1]; link++)
+        {
+            int l = graph->targets[link];
 
-                /* Insert first city in the new Path. */
-                insert_city(&((*transitive_closure)[*tc_size - 1]), i);
+            /* Ignore self-references. */
+            if (start == l)
+            {
+                continue;
+            }
 
-                /* Insert second city in the new Path. */
-                insert_city(&((*transitive_closure)[*tc_size - 1]), j);
+            /* Add the combined path to the transitive closure if it has not already been added. */
+            if (check_repetition(start, l, pairs) == 1)
+            {
+                continue;
             }
+
+            /* The new path is the current one followed by city l. */
+            add_path(transitive_closure, tc_size, start, l, i);
+            add_pair(pairs, start, l, *tc_size - 1);
         }
     }
 }
 
-void insert_city(PATH *path, int city_number)
+int check_repetition(int start, int end, PAIR_SET *pairs)
 {
-    CITY *q = NULL; /* helping pointer to go through the list */
-    CITY *new_city = (CITY *)malloc(sizeof(CITY));
+    return has_pair(pairs, start, end);
+}
 
-    if (new_city == NULL)
+int get_path(PATH *transitive_closure, int index, int *path)
+{
+    int length = 1;
+
+    /* Counts the cities, then writes them from the last one back. */
+    for (int i = index; i != -1; i = transitive_closure[i].previous)
     {
-        printf("Error: Unable to Allocate Memory \n");
-        exit(EXIT_FAILURE);
+        length++;
     }
+    path[0] = transitive_closure[index].start;
+    for (int i = index, k = length - 1; i != -1; i = transitive_closure[i].previous, k--)
+    {
+        path[k] = transitive_closure[i].end;
+    }
+    return length;
+}
 
-    new_city->next = NULL;
-    new_city->number = city_number;
+void check_for_listed_path(PATH *transitive_closure, int city_count, PAIR_SET *pairs,
+                           char *cities)
+{
+    int start_city, end_city, index = -1;
+    int *path = (int *)malloc(((size_t)city_count + 1) * sizeof(int));
 
-    /* If path is empty, add the new city as the head of the path. */
-    if (path->head == NULL)
+    if (path == NULL)
     {
-        path->head = new_city;
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
     }
-    /* If path is not empty, go through the list and add the new city at the end. */
-    else
+
+    get_cities(cities, &start_city, &end_city);
+    if (start_city >= 0 && start_city < city_count && end_city >= 0 && end_city < city_count)
     {
-        q = path->head;
+        index = find_pair(pairs, start_city, end_city);
+    }
 
-        while (q->next != NULL)
-        {
-            q = q->next;
-        }
+    /* The table has a single path between the cities, which is one of the shortest. */
+    print_path(path, (index == -1) ? 0 : get_path(transitive_closure, index, path));
+    free(path);
+}
 
-        q->next = new_city;
+void print_path(int *path, int length)
+{
+    if (length == 0)
+    {
+        printf("No Path Exists!\n");
+        return;
     }
-    (path->size)++;
+
+    printf("Yes Path Exists!\n");
+    for (int i = 0; i < length - 1; i++)
+    {
+        printf("%d => ", path[i]);
+    }
+    printf("%d\n", path[length - 1]);
 }
 
-void build_transitive_closure(PATH **transitive_closure, int *tc_size, int **neighbor_table, int N)
+void print_transitive_closure(PATH *transitive_closure, int tc_size)
 {
-    /* Iterates through the transitive closure table. */
-    for (int i = 0; i < *tc_size; i++)
-    {        
-        CITY *q = (*transitive_closure)[i].head; /* helping pointer to go through the list */
-        
-        /* q gets the poiner of the last city of the current path. */
-        while (q->next != NULL)
-        {               
-            q = q->next;           
-        }    
-
-        /* Iterates through the elements of neighbor table. */
-        for (int k = 0; k < N; k++)
-        {             
-            for (int l = 0; l < N; l++)
-            {        
-                /* Ignore self-references. */
-                if ((*transitive_closure)[i].head->number == l)
-                {
-                    continue;
-                }   
-                
-                /* 
-                * If k is mutual for current path and neighbor path, then add the
-                * combined path to the transitive closure if it has not already been added.          
-                */
-                if (q->number == k && neighbor_table[k][l] == 1)
-                {                      
-                    if (check_repetition((*transitive_closure)[i].head->number, l,
-                                          *transitive_closure, *tc_size) == 1)
-                    {
-                        continue;
-                    }
-
-                    (*tc_size)++;
-
-                    /* Increase the transitive closure array to new size. */
-                    PATH *tmp = (PATH *)realloc(*transitive_closure, (*tc_size) * sizeof(PATH));
-
-                    if (tmp == NULL)
-                    {
-                        printf("Error: Unable to Allocate Memory using realloc\n");
-                        exit(EXIT_FAILURE);
-                    }
-
-                    *transitive_closure = tmp;
-                     
-                    /* Initial values for Paths. */
-                    (*transitive_closure)[*tc_size - 1].head = NULL;
-                    (*transitive_closure)[*tc_size - 1].size = 0;
-
-                    /* Copies old path to the new one, before adding the last city. */
-                    copy_path(&((*transitive_closure)[*tc_size - 1]), (*transitive_closure)[i]);
-
-                    /* Insert last city in the new Path. */
-                    insert_city(&((*transitive_closure)[*tc_size - 1]), l);                    
-                }
-            }
-        }
+    CLOSURE_WRITER *writer = new_closure_writer(stdout, FORMAT_TEXT, 0);
+
+    /* Goes through all the paths in the transitive closure table. */
+    for (int i = 0; i < tc_size; i++)
+    {
+        write_closure_pair(writer, transitive_closure[i].start, transitive_closure[i].end);
     }
+    close_closure_writer(writer);
 }
 
-int check_repetition(int start, int end, PATH *transitive_closure, int tc_size)
+void save_transitive_closure(PATH *transitive_closure, int tc_size, int city_count,
+                             char *filename, int format)
 {
-    CITY *q = NULL; /* helping pointer to go through the list */
+    FILE *fp = open_output_file(filename);
+    BIT_MATRIX *closure = NULL;
 
-    /* Iterates through the transitive closure table. */
-    for (int i = 0; i < tc_size; i++)
+    if (format == FORMAT_TEXT)
     {
-        q = transitive_closure[i].head;
+        CLOSURE_WRITER *writer = new_closure_writer(fp, FORMAT_TEXT, city_count);
 
-        /* Makes q point at the last city of each path. */
-        while (q->next != NULL)
-        {
-            q = q->next;
-        }
-        /* 
-        * If the starting cities are equal and the ending cities are equal, then the 
-        * repetition is true. 
-        */
-        if (start == transitive_closure[i].head->number && end == q->number)
+        /* Goes through all the paths in the transitive closure table. */
+        for (int i = 0; i < tc_size; i++)
         {
-            return 1;
+            write_closure_pair(writer, transitive_closure[i].start, transitive_closure[i].end);
         }
+        close_closure_writer(writer);
+        fclose(fp);
+        return;
     }
-    return 0;
-}
 
-void copy_path(PATH *new_path, PATH old_path)
-{
-    CITY *q = old_path.head; /* helping pointer to go through the list */
-
-    /* For each city number in the old path, insert a new city in the new path. */
-    for (int i = 0; i < old_path.size; i++)
+    /* The binary formats go city by city, so the paths are sorted into a bit matrix first. */
+    closure = new_bit_matrix(city_count);
+    for (int i = 0; i < tc_size; i++)
     {
-        insert_city(new_path, q->number);
-        q = q->next;
+        set_bit(closure, transitive_closure[i].start, transitive_closure[i].end);
     }
+    print_closure_matrix(fp, closure, format);
+    free_bit_matrix(closure);
+    fclose(fp);
 }
 
-void check_for_path(PATH *transitive_closure, int tc_size, int start_city, int end_city)
+BIT_MATRIX *build_link_matrix(GRAPH *graph)
 {
-    CITY *q = NULL; /* helping pointer to go through the list */
-    
-    /* Iterates throug the transitive closure table. */
-    for (int i = 0; i < tc_size; i++)
-    {     
-        q = transitive_closure[i].head;
+    BIT_MATRIX *links = new_bit_matrix(graph->city_count);
 
-        /* Makes q point to the last city of each path. */
-        while (q->next != NULL)
+    for (int i = 0; i < graph->city_count; i++)
+    {
+        for (long link = graph->offsets[i]; link < graph->offsets[i + 1]; link++)
         {
-            q = q->next;
+            /* Ignore self-references. */
+            if (graph->targets[link] != i)
+            {
+                set_bit(links, i, graph->targets[link]);
+            }
         }
+    }
+    return links;
+}
 
-        /* 
-        * If the start city equals the city of the current i path and the end city
-        * equals the last city of the current i path then the path exists.
-        */
-        if (start_city == (transitive_closure[i].head->number) && end_city == (q->number))
-        {
-            printf("Yes Path Exists!\n");
-            print_successful_path(transitive_closure, i);
-            return;
-        }       
+void print_closure_matrix(FILE *fp, BIT_MATRIX *closure, int format)
+{
+    CLOSURE_WRITER *writer = new_closure_writer(fp, format, closure->size);
+
+    for (int i = 0; i < closure->size; i++)
+    {
+        write_closure_row(writer, i, get_row(closure, i));
     }
-    printf("No Path Exists!\n");
+    close_closure_writer(writer);
 }
 
-void print_transitive_closure(PATH *transitive_closure, int tc_size)
+void save_closure_matrix(BIT_MATRIX *closure, char *filename, int format)
 {
-    CITY *q = NULL; /* helping pointer to go through the list */
+    FILE *fp = open_output_file(filename);
 
-    printf("R* table\n");
+    print_closure_matrix(fp, closure, format);
+    fclose(fp);
+}
 
-    /* Goes through all the paths in the transitive closure table. */
-    for (int i = 0; i < tc_size; i++)
+void print_condensed_closure(FILE *fp, CONDENSATION *condensation, int format)
+{
+    int words = (condensation->city_count + WORD_BITS - 1) / WORD_BITS;
+    unsigned long long *row = (unsigned long long *)malloc(((size_t)words + 1) *
+                                                           sizeof(unsigned long long));
+    CLOSURE_WRITER *writer = NULL;
+
+    if (row == NULL)
     {
-        q = transitive_closure[i].head;
-        printf("%d -> ", q->number);
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
 
-        /* Makes q point to the last city of the current path. */
-        while (q->next != NULL)
-        {            
-            q = q->next;
-        }
-        printf("%d\n", q->number);
+    writer = new_closure_writer(fp, format, condensation->city_count);
+    for (int i = 0; i < condensation->city_count; i++)
+    {
+        get_reached_cities(condensation, i, row);
+        write_closure_row(writer, i, row);
     }
+    close_closure_writer(writer);
+    free(row);
 }
 
-void print_successful_path(PATH *transitive_closure, int index)
+void save_condensed_closure(CONDENSATION *condensation, char *filename, int format)
 {
-    CITY *q = NULL; /* helping pointer to go through the list */
-    
-    q = transitive_closure[index].head;
+    FILE *fp = open_output_file(filename);
 
-    /* q goes through the cities of the successful path.*/
-    while (q->next != NULL)
-    {
-        printf("%d => ", q->number);
-        q = q->next;
-    }
-    printf("%d\n", q->number);
+    print_condensed_closure(fp, condensation, format);
+    fclose(fp);
 }
 
-void save_transitive_closure(PATH *transitive_closure, int tc_size, char *filename)
+FILE *open_output_file(char *filename)
 {
-    CITY *q = NULL; /* helping pointer to go through the list */
     char *output_filename = (char *)malloc((strlen(filename) + 10) * sizeof(char));
+    FILE *fp = NULL;
 
     if (output_filename == NULL)
     {
@@ -696,9 +1198,7 @@ void save_transitive_closure(PATH *transitive_closure, int tc_size, char *filena
 
     /* Builds the output file name. */
     strcpy(output_filename, "out-");
-    strcat(output_filename, filename);  
-
-    FILE *fp = NULL;
+    strcat(output_filename, filename);
 
     if ((fp = fopen(output_filename, "w")) == NULL)
     {
@@ -707,25 +1207,8 @@ void save_transitive_closure(PATH *transitive_closure, int tc_size, char *filena
     }
 
     printf("Saving %s...\n", output_filename);
-
-    fprintf(fp, "R* table\n");
-
-    /* Goes through all the paths in the transitive closure table. */
-    for (int i = 0; i < tc_size; i++)
-    {
-        q = transitive_closure[i].head;
-        fprintf(fp, "%d -> ", q->number);
-
-        /* Makes q point to the last city of the current path. */
-        while (q->next != NULL)
-        {            
-            q = q->next;
-        }
-        fprintf(fp, "%d\n", q->number);
-    }
-    
     free(output_filename);
-    fclose(fp);
+    return fp;
 }
 
 /** @brief Program entrypoint.
@@ -0,0 +1,209 @@
+#include "closure_writer.h"
+
+/** @brief Writes the buffer to the file and empties it.
+ *
+ *   @param writer the writer
+ *   @return void
+ */
+static void flush_buffer(CLOSURE_WRITER *writer)
+{
+    if (writer->used > 0 && fwrite(writer->buffer, 1, writer->used, writer->fp) != writer->used)
+    {
+        printf("Error: Unable to write the transitive closure\n");
+        exit(EXIT_FAILURE);
+    }
+    writer->used = 0;
+}
+
+/** @brief Makes room in the buffer for a number of bytes.
+ *
+ *   @param writer the writer
+ *   @param size   the number of bytes, at most WRITER_BUFFER_SIZE
+ *   @return void
+ */
+static void reserve_buffer(CLOSURE_WRITER *writer, size_t size)
+{
+    if (writer->used + size > WRITER_BUFFER_SIZE)
+    {
+        flush_buffer(writer);
+    }
+}
+
+/** @brief Adds a number to the buffer as a little-endian number.
+ *
+ *   @param writer the writer, with room for the bytes
+ *   @param value  the number
+ *   @param size   the number of bytes, 4 or 8
+ *   @return void
+ */
+static void put_number(CLOSURE_WRITER *writer, unsigned long long value, int size)
+{
+    for (int b = 0; b < size; b++)
+    {
+        writer->buffer[writer->used++] = (char)(unsigned char)(value >> (8 * b));
+    }
+}
+
+/** @brief Adds a city to the buffer in decimal digits.
+ *
+ *   @param writer the writer, with room for the digits
+ *   @param city   the city, 0 or more
+ *   @return void
+ */
+static void put_digits(CLOSURE_WRITER *writer, int city)
+{
+    char digits[12];
+    int count = 0;
+
+    /* The digits come out from the last one, so they are put back in the other order. */
+    do
+    {
+        digits[count++] = (char)('0' + city % 10);
+        city /= 10;
+    } while (city > 0);
+
+    while (count > 0)
+    {
+        writer->buffer[writer->used++] = digits[--count];
+    }
+}
+
+CLOSURE_WRITER *new_closure_writer(FILE *fp, int format, int city_count)
+{
+    CLOSURE_WRITER *writer = (CLOSURE_WRITER *)malloc(sizeof(CLOSURE_WRITER));
+
+    if (writer == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    writer->fp = fp;
+    writer->format = format;
+    writer->city_count = city_count;
+    writer->pair_count = 0;
+    writer->offsets = NULL;
+    writer->used = 0;
+    writer->buffer = (char *)malloc(WRITER_BUFFER_SIZE);
+    if (format == FORMAT_CSR)
+    {
+        writer->offsets = (long *)malloc(((size_t)city_count + 1) * sizeof(long));
+    }
+
+    if (writer->buffer == NULL || (format == FORMAT_CSR && writer->offsets == NULL))
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (format == FORMAT_TEXT)
+    {
+        memcpy(writer->buffer, "R* table\n", 9);
+        writer->used = 9;
+    }
+    else if (format == FORMAT_BITS)
+    {
+        memcpy(writer->buffer, CLOSURE_BITS_MAGIC, 4);
+        writer->used = 4;
+        put_number(writer, (unsigned)city_count, 4);
+    }
+    else
+    {
+        /* The number of pairs and the offsets are only known at the end, 0 until then. */
+        memcpy(writer->buffer, GRAPH_MAGIC, 4);
+        writer->used = 4;
+        put_number(writer, (unsigned)city_count, 4);
+        put_number(writer, 0, 8);
+        for (int i = 0; i <= city_count; i++)
+        {
+            reserve_buffer(writer, 8);
+            put_number(writer, 0, 8);
+        }
+    }
+    return writer;
+}
+
+void write_closure_pair(CLOSURE_WRITER *writer, int from, int to)
+{
+    /* Two numbers of up to 10 digits, " -> " and the end of the line. */
+    reserve_buffer(writer, 32);
+    put_digits(writer, from);
+    memcpy(writer->buffer + writer->used, " -> ", 4);
+    writer->used += 4;
+    put_digits(writer, to);
+    writer->buffer[writer->used++] = '\n';
+    writer->pair_count++;
+}
+
+void write_closure_row(CLOSURE_WRITER *writer, int city, unsigned long long *row)
+{
+    int words = (writer->city_count + WORD_BITS - 1) / WORD_BITS;
+
+    if (writer->format == FORMAT_CSR)
+    {
+        writer->offsets[city] = writer->pair_count;
+    }
+
+    for (int w = 0; w < words; w++)
+    {
+        unsigned long long word = row[w];
+
+        /* Ignore self-references. */
+        if (w == city / WORD_BITS)
+        {
+            word &= ~(1ULL << (city % WORD_BITS));
+        }
+
+        if (writer->format == FORMAT_BITS)
+        {
+            reserve_buffer(writer, 8);
+            put_number(writer, word, 8);
+            continue;
+        }
+
+        /* Only the set bits of each word are visited. */
+        while (word != 0)
+        {
+            int j = w * WORD_BITS + __builtin_ctzll(word);
+
+            word &= word - 1;
+            if (writer->format == FORMAT_TEXT)
+            {
+                write_closure_pair(writer, city, j);
+            }
+            else
+            {
+                reserve_buffer(writer, 4);
+                put_number(writer, (unsigned)j, 4);
+                writer->pair_count++;
+            }
+        }
+    }
+}
+
+void close_closure_writer(CLOSURE_WRITER *writer)
+{
+    flush_buffer(writer);
+
+    if (writer->format == FORMAT_CSR)
+    {
+        writer->offsets[writer->city_count] = writer->pair_count;
+        if (fseek(writer->fp, 8, SEEK_SET) != 0)
+        {
+            printf("Error: Unable to write the transitive closure\n");
+            exit(EXIT_FAILURE);
+        }
+        put_number(writer, (unsigned long long)writer->pair_count, 8);
+        for (int i = 0; i <= writer->city_count; i++)
+        {
+            reserve_buffer(writer, 8);
+            put_number(writer, (unsigned long long)writer->offsets[i], 8);
+        }
+        flush_buffer(writer);
+    }
+    fflush(writer->fp);
+
+    free(writer->offsets);
+    free(writer->buffer);
+    free(writer);
+}
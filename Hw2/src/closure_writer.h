@@ -0,0 +1,83 @@
+#ifndef CLOSURE_WRITER_H
+#define CLOSURE_WRITER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bit_matrix.h"
+#include "graph.h"
+
+/** @brief A line "i -> j" for each pair after "R* table", as the closure was always saved. */
+#define FORMAT_TEXT 0
+
+/** @brief A bit matrix: CLOSURE_BITS_MAGIC, N as a 32-bit little-endian number and N rows. */
+#define FORMAT_BITS 1
+
+/** @brief A binary graph file, like save_binary_graph(), with a link for each pair. */
+#define FORMAT_CSR 2
+
+/** @brief The first bytes of a closure saved with FORMAT_BITS. */
+#define CLOSURE_BITS_MAGIC "CLNB"
+
+/** @brief The number of bytes gathered before they are written to the file. */
+#define WRITER_BUFFER_SIZE 65536
+
+/** @brief Writes the pairs of a transitive closure to a file in one of the formats.
+ *
+ *   The bytes are gathered in a large buffer and written with one fwrite() at a time, and
+ *   the numbers of the text format are turned into digits by hand instead of with
+ *   fprintf(). A pair of a city with itself is never written.
+ *
+ *   With FORMAT_BITS each row is (N + 63) / 64 words of 64-bit little-endian numbers, bit j
+ *   of row i being bit j % 64 of word j / 64. With FORMAT_CSR the pairs of each city are
+ *   sorted, and the file can be read again as an input file.
+ */
+typedef struct
+{
+    FILE *fp;           /* the file to write to */
+    int format;         /* FORMAT_TEXT, FORMAT_BITS or FORMAT_CSR */
+    int city_count;     /* number of cities */
+    long pair_count;    /* the number of pairs written so far */
+    long *offsets;      /* where the pairs of each city start, for FORMAT_CSR only */
+    char *buffer;       /* the bytes not written to the file yet */
+    size_t used;        /* the number of bytes in buffer */
+} CLOSURE_WRITER;
+
+/** @brief Starts writing a transitive closure, with the header of its format.
+ *
+ *   @param fp         the file to write to, which the writer does not close
+ *   @param format     FORMAT_TEXT, FORMAT_BITS or FORMAT_CSR
+ *   @param city_count the number of cities
+ *   @return the writer
+ */
+CLOSURE_WRITER *new_closure_writer(FILE *fp, int format, int city_count);
+
+/** @brief Writes a pair, in any order, for FORMAT_TEXT only.
+ *
+ *   @param writer the writer
+ *   @param from   the starting city
+ *   @param to     the ending city
+ *   @return void
+ */
+void write_closure_pair(CLOSURE_WRITER *writer, int from, int to);
+
+/** @brief Writes the pairs of the next city, in increasing order of the cities.
+ *
+ *   @param writer the writer
+ *   @param city   the starting city, one more than the last one written
+ *   @param row    the bits of the cities it reaches
+ *   @return void
+ */
+void write_closure_row(CLOSURE_WRITER *writer, int city, unsigned long long *row);
+
+/** @brief Writes what is left in the buffer and frees up the writer from memory.
+ *
+ *   With FORMAT_CSR, the number of pairs and the offsets are written at the start of the
+ *   file, which needs to be seekable, after all the rows.
+ *
+ *   @param writer the writer
+ *   @return void
+ */
+void close_closure_writer(CLOSURE_WRITER *writer);
+
+#endif
@@ -0,0 +1,434 @@
+#include "dynamic_closure.h"
+#include "parallel_closure.h"
+#include "query.h"
+#include "scc.h"
+
+DYNAMIC_CLOSURE *new_dynamic_closure(GRAPH *graph, int thread_count)
+{
+    int N = graph->city_count;
+    DYNAMIC_CLOSURE *closure = (DYNAMIC_CLOSURE *)malloc(sizeof(DYNAMIC_CLOSURE));
+
+    if (closure == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    closure->city_count = N;
+    closure->links = (int **)malloc(((size_t)N + 1) * sizeof(int *));
+    closure->link_count = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    closure->link_capacity = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    closure->affected = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    closure->affected_list = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    closure->queue = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    closure->parent = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    closure->seen = (int *)calloc((size_t)N + 1, sizeof(int));
+    closure->search_count = 0;
+
+    if (closure->links == NULL || closure->link_count == NULL || closure->link_capacity == NULL ||
+        closure->affected == NULL || closure->affected_list == NULL || closure->queue == NULL ||
+        closure->parent == NULL || closure->seen == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < N; i++)
+    {
+        int count = (int)(graph->offsets[i + 1] - graph->offsets[i]);
+
+        closure->link_count[i] = count;
+        closure->link_capacity[i] = count;
+        closure->affected[i] = -1;
+        closure->links[i] = (int *)malloc(((size_t)count + 1) * sizeof(int));
+        if (closure->links[i] == NULL)
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(closure->links[i], graph->targets + graph->offsets[i], (size_t)count * sizeof(int));
+    }
+
+    closure->reach = bfs_closure(graph, thread_count);
+    return closure;
+}
+
+/** @brief Starts a new search, so no city is seen by it yet.
+ *
+ *   @param closure the closure
+ *   @return the number of the new search
+ */
+static int new_search_number(DYNAMIC_CLOSURE *closure)
+{
+    /* After 2^31 searches the numbers start over, with every city unseen again. */
+    if (closure->search_count == 2147483647)
+    {
+        memset(closure->seen, 0, (size_t)closure->city_count * sizeof(int));
+        closure->search_count = 0;
+    }
+    return ++closure->search_count;
+}
+
+int insert_link(DYNAMIC_CLOSURE *closure, int from, int to)
+{
+    BIT_MATRIX *reach = closure->reach;
+    unsigned long long *to_row = get_row(reach, to);
+    int already_reached = get_bit(reach, from, to);
+
+    for (int l = 0; l < closure->link_count[from]; l++)
+    {
+        if (closure->links[from][l] == to)
+        {
+            return 0;
+        }
+    }
+
+    if (closure->link_count[from] == closure->link_capacity[from])
+    {
+        closure->link_capacity[from] = 2 * closure->link_capacity[from] + 1;
+        closure->links[from] = (int *)realloc(closure->links[from],
+                                              ((size_t)closure->link_capacity[from] + 1) *
+                                                  sizeof(int));
+        if (closure->links[from] == NULL)
+        {
+            printf("Error: Unable to Allocate Memory using realloc\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    closure->links[from][closure->link_count[from]++] = to;
+
+    if (already_reached)
+    {
+        return 1;
+    }
+
+    /* The column of from tells which cities reach it. */
+    for (int city = 0; city < closure->city_count; city++)
+    {
+        if (city != from && get_bit(reach, city, from) == 0)
+        {
+            continue;
+        }
+        if (city != to)
+        {
+            or_row(get_row(reach, city), to_row, reach->words);
+        }
+        set_bit(reach, city, to);
+    }
+    return 1;
+}
+
+/** @brief Checks whether one city reaches another, searching the links.
+ *
+ *   @param closure the closure, with its links up to date
+ *   @param from    the starting city
+ *   @param to      the ending city
+ *   @return 1 if a path exists or 0 otherwise
+ */
+static int search_links(DYNAMIC_CLOSURE *closure, int from, int to)
+{
+    int search = new_search_number(closure);
+    int head = 0, tail = 0;
+
+    closure->queue[tail++] = from;
+    while (head < tail)
+    {
+        int city = closure->queue[head++];
+
+        for (int l = 0; l < closure->link_count[city]; l++)
+        {
+            int next = closure->links[city][l];
+
+            if (next == to)
+            {
+                return 1;
+            }
+            if (closure->seen[next] != search)
+            {
+                closure->seen[next] = search;
+                closure->queue[tail++] = next;
+            }
+        }
+    }
+    return 0;
+}
+
+int delete_link(DYNAMIC_CLOSURE *closure, int from, int to)
+{
+    BIT_MATRIX *reach = closure->reach;
+    unsigned long long *row = NULL;
+    int *sources = NULL, *targets = NULL;
+    GRAPH *affected_graph = NULL;
+    CONDENSATION *condensation = NULL;
+    int count = 0;
+    long link_count = 0;
+    int l = 0;
+
+    while (l < closure->link_count[from] && closure->links[from][l] != to)
+    {
+        l++;
+    }
+    if (l == closure->link_count[from])
+    {
+        return 0;
+    }
+    closure->links[from][l] = closure->links[from][--closure->link_count[from]];
+
+    /* Another path from the starting to the ending city keeps every path. */
+    if (search_links(closure, from, to))
+    {
+        return 1;
+    }
+
+    /* Only the cities that reached the starting city can have used the link. */
+    for (int city = 0; city < closure->city_count; city++)
+    {
+        if (city == from || get_bit(reach, city, from))
+        {
+            closure->affected[city] = count;
+            closure->affected_list[count++] = city;
+            link_count += closure->link_count[city];
+        }
+    }
+
+    /* The links between those cities, numbered in the order of affected_list. */
+    sources = (int *)malloc(((size_t)link_count + 1) * sizeof(int));
+    targets = (int *)malloc(((size_t)link_count + 1) * sizeof(int));
+    row = (unsigned long long *)malloc(((size_t)reach->words + 1) * sizeof(unsigned long long));
+    if (sources == NULL || targets == NULL || row == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    link_count = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int city = closure->affected_list[i];
+
+        for (l = 0; l < closure->link_count[city]; l++)
+        {
+            if (closure->affected[closure->links[city][l]] != -1)
+            {
+                sources[link_count] = i;
+                targets[link_count++] = closure->affected[closure->links[city][l]];
+            }
+        }
+    }
+    affected_graph = build_graph(count, link_count, sources, targets, NULL);
+    condensation = condense_graph(affected_graph);
+
+    /*
+     * The components only link to components with a smaller number, so those rows are done
+     * when a component is. The rows of the other cities did not change.
+     */
+    for (int c = 0; c < condensation->component_count; c++)
+    {
+        memset(row, 0, (size_t)reach->words * sizeof(unsigned long long));
+        for (long m = condensation->first_member[c]; m < condensation->first_member[c + 1]; m++)
+        {
+            int city = closure->affected_list[condensation->members[m]];
+
+            for (l = 0; l < closure->link_count[city]; l++)
+            {
+                int next = closure->links[city][l];
+                int next_id = closure->affected[next];
+
+                row[next / WORD_BITS] |= 1ULL << (next % WORD_BITS);
+                if (next_id == -1 || condensation->component[next_id] != c)
+                {
+                    or_row(row, get_row(reach, next), reach->words);
+                }
+            }
+        }
+        for (long m = condensation->first_member[c]; m < condensation->first_member[c + 1]; m++)
+        {
+            memcpy(get_row(reach, closure->affected_list[condensation->members[m]]), row,
+                   (size_t)reach->words * sizeof(unsigned long long));
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        closure->affected[closure->affected_list[i]] = -1;
+    }
+    free_condensation(condensation);
+    free_graph(affected_graph);
+    free(sources);
+    free(targets);
+    free(row);
+    return 1;
+}
+
+int find_dynamic_path(DYNAMIC_CLOSURE *closure, int start_city, int end_city, int *path)
+{
+    BIT_MATRIX *reach = closure->reach;
+    int search = 0;
+    int head = 0, tail = 0, length = 0;
+
+    if (start_city < 0 || start_city >= closure->city_count || end_city < 0 ||
+        end_city >= closure->city_count || start_city == end_city ||
+        get_bit(reach, start_city, end_city) == 0)
+    {
+        return 0;
+    }
+
+    search = new_search_number(closure);
+    closure->seen[start_city] = search;
+    closure->parent[start_city] = -1;
+    closure->queue[tail++] = start_city;
+
+    /* Every city of a shortest path reaches the ending city. */
+    while (head < tail && closure->seen[end_city] != search)
+    {
+        int city = closure->queue[head++];
+
+        for (int l = 0; l < closure->link_count[city]; l++)
+        {
+            int next = closure->links[city][l];
+
+            if (closure->seen[next] != search &&
+                (next == end_city || get_bit(reach, next, end_city)))
+            {
+                closure->seen[next] = search;
+                closure->parent[next] = city;
+                closure->queue[tail++] = next;
+            }
+        }
+    }
+
+    /* Counts the cities, then writes them from the last one back. */
+    for (int city = end_city; city != -1; city = closure->parent[city])
+    {
+        length++;
+    }
+    for (int city = end_city, k = length - 1; city != -1; city = closure->parent[city], k--)
+    {
+        path[k] = city;
+    }
+    return length;
+}
+
+void answer_updates(GRAPH *graph, char *update_filename, int thread_count)
+{
+    DYNAMIC_CLOSURE *closure = NULL;
+    int *path = NULL;
+    char line[256];
+    long line_number = 0;
+    int result = 0;
+    FILE *fp = NULL;
+
+    /* A closure of the cities takes as much memory as the largest closure of components. */
+    if (graph->city_count > MAX_CLOSURE_COMPONENTS)
+    {
+        printf("Too many cities for -u, it takes at most %d!\n", MAX_CLOSURE_COMPONENTS);
+        exit(EXIT_FAILURE);
+    }
+    closure = new_dynamic_closure(graph, thread_count);
+    path = (int *)malloc(((size_t)graph->city_count + 1) * sizeof(int));
+    if (path == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    if (strcmp(update_filename, "-") == 0)
+    {
+        fp = stdin;
+    }
+    else if ((fp = fopen(update_filename, "r")) == NULL)
+    {
+        printf("Update file cannot be read!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    while ((result = read_query_line(line, sizeof(line), fp)) != 0)
+    {
+        char *text = line + strspn(line, " \t");
+        int start_city = -1, end_city = -1, length = 0;
+
+        line_number++;
+        if (result < 0)
+        {
+            printf("Update on line %ld is too long\n", line_number);
+            printf("Update format: +number1 number2, -number1 number2 or number1,number2\n");
+            exit(EXIT_FAILURE);
+        }
+        if (*text == '\0' || strspn(text, "\r\n") == strlen(text))
+        {
+            continue;
+        }
+
+        /* A change needs two existing cities, a query answers "no" for other cities. */
+        if (*text == '+' || *text == '-')
+        {
+            if (parse_query(text + 1, &start_city, &end_city) == 0 || start_city < 0 ||
+                start_city >= graph->city_count || end_city < 0 ||
+                end_city >= graph->city_count)
+            {
+                printf("Invalid update on line %ld\n", line_number);
+                printf("Update format: +number1 number2, -number1 number2 or number1,number2\n");
+                exit(EXIT_FAILURE);
+            }
+            if (*text == '+')
+            {
+                insert_link(closure, start_city, end_city);
+            }
+            else
+            {
+                delete_link(closure, start_city, end_city);
+            }
+            continue;
+        }
+
+        if (parse_query(text, &start_city, &end_city) == 0)
+        {
+            printf("Invalid update on line %ld\n", line_number);
+            printf("Update format: +number1 number2, -number1 number2 or number1,number2\n");
+            exit(EXIT_FAILURE);
+        }
+        length = find_dynamic_path(closure, start_city, end_city, path);
+        if (length == 0)
+        {
+            printf("no\n");
+        }
+        else
+        {
+            printf("yes ");
+            for (int i = 0; i < length; i++)
+            {
+                printf((i < length - 1) ? "%d => " : "%d\n", path[i]);
+            }
+        }
+
+        /* Someone typing the changes sees each answer right away. */
+        if (fp == stdin)
+        {
+            fflush(stdout);
+        }
+    }
+    fflush(stdout);
+
+    if (fp != stdin)
+    {
+        fclose(fp);
+    }
+    free(path);
+    free_dynamic_closure(closure);
+}
+
+void free_dynamic_closure(DYNAMIC_CLOSURE *closure)
+{
+    for (int i = 0; i < closure->city_count; i++)
+    {
+        free(closure->links[i]);
+    }
+    free(closure->links);
+    free(closure->link_count);
+    free(closure->link_capacity);
+    free_bit_matrix(closure->reach);
+    free(closure->affected);
+    free(closure->affected_list);
+    free(closure->queue);
+    free(closure->parent);
+    free(closure->seen);
+    free(closure);
+}
@@ -0,0 +1,103 @@
+#ifndef DYNAMIC_CLOSURE_H
+#define DYNAMIC_CLOSURE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bit_matrix.h"
+#include "graph.h"
+
+/** @brief Represents the transitive closure of links that are added and removed one at a time.
+ *
+ *   The links of each city are kept in an array that grows, instead of the CSR form of a
+ *   GRAPH, and the closure is a bit matrix kept up to date after each change, so a query
+ *   never waits for the closure to be built again.
+ */
+typedef struct
+{
+    int city_count;      /* number of cities */
+    int **links;         /* the cities each city links to, in no order */
+    int *link_count;     /* the number of links of each city */
+    int *link_capacity;  /* the number of links each array has room for */
+    BIT_MATRIX *reach;   /* bit d of row c is set if city c reaches city d */
+    int *affected;       /* where each city is in affected_list, or -1 if it is not */
+    int *affected_list;  /* the cities that may lose paths with the link being removed */
+    int *queue;          /* room for a queue of all the cities */
+    int *parent;         /* the city before each city reached by the last search */
+    int *seen;           /* the number of the last search that reached each city */
+    int search_count;    /* the number of searches so far */
+} DYNAMIC_CLOSURE;
+
+/** @brief Builds the closure of a graph, to be changed afterwards.
+ *
+ *   @param graph        the links between the cities
+ *   @param thread_count the number of threads of the first closure, 0 for one per processor
+ *   @return the closure
+ */
+DYNAMIC_CLOSURE *new_dynamic_closure(GRAPH *graph, int thread_count);
+
+/** @brief Adds a link and the paths it makes.
+ *
+ *   If the starting city already reaches the ending city, no path is new. Otherwise every
+ *   city that reaches the starting city, and the starting city itself, now reaches the
+ *   ending city and everything it reaches: row[x] |= row[to], one word at a time.
+ *
+ *   @param closure the closure
+ *   @param from    the city the link starts from
+ *   @param to      the city the link goes to
+ *   @return 1 if the link was added or 0 if it already existed
+ */
+int insert_link(DYNAMIC_CLOSURE *closure, int from, int to);
+
+/** @brief Removes a link and the paths that needed it.
+ *
+ *   If the starting city still reaches the ending city without the link, no path is lost.
+ *   Otherwise only the cities that reached the starting city can lose paths. Their links
+ *   are condensed into components, and the rows of the components are built again in the
+ *   order Tarjan's algorithm finishes them, taking the rows of the other cities as they are,
+ *   since none of them reaches the link.
+ *
+ *   @param closure the closure
+ *   @param from    the city the link starts from
+ *   @param to      the city the link goes to
+ *   @return 1 if the link was removed or 0 if it did not exist
+ */
+int delete_link(DYNAMIC_CLOSURE *closure, int from, int to);
+
+/** @brief Finds the shortest path between two cities.
+ *
+ *   The closure answers whether the path exists. A breadth-first search then only goes
+ *   through the cities that reach the ending city.
+ *
+ *   @param closure    the closure
+ *   @param start_city the starting city
+ *   @param end_city   the ending city
+ *   @param path       the cities of the path, room for all the cities
+ *   @return the number of cities of the path, or 0 if no path exists
+ */
+int find_dynamic_path(DYNAMIC_CLOSURE *closure, int start_city, int end_city, int *path);
+
+/** @brief Applies a file of changes to the links and answers the queries between them.
+ *
+ *   Each line is "+u v" to add a link from city u to city v, "-u v" to remove it, or a query
+ *   "u,v" answered like with answer_queries(), "yes" followed by the shortest path or "no".
+ *   Changes print nothing. The answers are printed as soon as each query is read. The
+ *   closure has a bit for each pair of cities, so the program is terminated if there are
+ *   more than MAX_CLOSURE_COMPONENTS cities.
+ *
+ *   @param graph           the links between the cities before the changes
+ *   @param update_filename the file of changes and queries, or "-" to read them from the
+ *                          console
+ *   @param thread_count    the number of threads of the first closure, 0 for one per processor
+ *   @return void
+ */
+void answer_updates(GRAPH *graph, char *update_filename, int thread_count);
+
+/** @brief Frees up the closure from memory.
+ *
+ *   @param closure the closure
+ *   @return void
+ */
+void free_dynamic_closure(DYNAMIC_CLOSURE *closure);
+
+#endif
@@ -0,0 +1,720 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "graph.h"
+
+/** @brief Compares two cities, for sorting the links of a city with qsort().
+ *
+ *   @param a the first city
+ *   @param b the second city
+ *   @return a negative number, 0 or a positive number as a is before, equal to or after b
+ */
+static int compare_cities(const void *a, const void *b)
+{
+    return (*(const int *)a > *(const int *)b) - (*(const int *)a < *(const int *)b);
+}
+
+/** @brief Compares two links packed as their city and distance, for sorting with qsort().
+ *
+ *   @param a the first link
+ *   @param b the second link
+ *   @return a negative number, 0 or a positive number as a is before, equal to or after b
+ */
+static int compare_weighted_links(const void *a, const void *b)
+{
+    unsigned long long x = *(const unsigned long long *)a, y = *(const unsigned long long *)b;
+
+    return (x > y) - (x < y);
+}
+
+/** @brief Allocates a graph with room for the specified number of links.
+ *
+ *   @param N          the number of cities
+ *   @param link_count the number of links
+ *   @return the graph, with its offsets and targets not set yet
+ */
+static GRAPH *new_graph(int N, long link_count)
+{
+    GRAPH *graph = (GRAPH *)malloc(sizeof(GRAPH));
+
+    if (graph == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    graph->city_count = N;
+    graph->link_count = link_count;
+    graph->offsets = (long *)malloc(((size_t)N + 1) * sizeof(long));
+    /* At least one target, so a graph without links still gets its own memory. */
+    graph->targets = (int *)malloc(((size_t)link_count + 1) * sizeof(int));
+    graph->weights = NULL;
+
+    if (graph->offsets == NULL || graph->targets == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    return graph;
+}
+
+GRAPH *read_graph(char *filename, int print_table)
+{
+    FILE *fp;
+    char magic[4];
+    char line[256];
+    int N = 0;
+    long link_count = 0;
+    GRAPH *graph = NULL;
+
+    if ((fp = fopen(filename, "rb")) == NULL)
+    {
+        printf("Input file cannot be read!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (fread(magic, 1, 4, fp) == 4 && (memcmp(magic, GRAPH_MAGIC, 4) == 0 ||
+                                        memcmp(magic, GRAPH_WEIGHTED_MAGIC, 4) == 0))
+    {
+        graph = read_binary_graph(fp, memcmp(magic, GRAPH_WEIGHTED_MAGIC, 4) == 0);
+        fclose(fp);
+        return graph;
+    }
+    rewind(fp);
+
+    /* The first line tells the text formats apart: N alone or N and M. */
+    if (fgets(line, sizeof(line), fp) == NULL)
+    {
+        printf("Input file is empty!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    switch (sscanf(line, "%d %ld", &N, &link_count))
+    {
+    case 1:
+        if (N < 0)
+        {
+            printf("Input file has an invalid number of cities!\n");
+            exit(EXIT_FAILURE);
+        }
+        graph = read_neighbor_table(fp, N);
+        if (print_table)
+        {
+            print_neighbor_table(graph);
+        }
+        break;
+    case 2:
+        if (N < 0 || link_count < 0)
+        {
+            printf("Input file has an invalid number of cities or links!\n");
+            exit(EXIT_FAILURE);
+        }
+        graph = read_link_list(fp, N, link_count);
+        break;
+    default:
+        printf("Input file has an invalid first line!\n");
+        exit(EXIT_FAILURE);
+    }
+    fclose(fp);
+    return graph;
+}
+
+/** @brief Checks whether a character separates the values of a neighbor table.
+ *
+ *   @param c the character
+ *   @return 1 if it is a space, a tab or the end of a line, or 0 otherwise
+ */
+static int is_space(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/** @brief Reads the next value of a neighbor table, like fscanf("%d") would.
+ *
+ *   @param text  where the reading is, moved past the value
+ *   @param end   the end of the table
+ *   @param value the value read
+ *   @return 1 if a value was read or 0 if the table has no valid value there
+ */
+static int scan_value(const char **text, const char *end, int *value)
+{
+    const char *p = *text;
+    long long number = 0;
+    int negative = 0;
+
+    while (p < end && is_space(*p))
+    {
+        p++;
+    }
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p++ == '-');
+    }
+    if (p == end || *p < '0' || *p > '9')
+    {
+        return 0;
+    }
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        number = 10 * number + (*p++ - '0');
+        if (number > INT_MAX)
+        {
+            return 0;
+        }
+    }
+    if (p < end && !is_space(*p))
+    {
+        return 0;
+    }
+
+    *value = negative ? (int)-number : (int)number;
+    *text = p;
+    return 1;
+}
+
+GRAPH *read_neighbor_table(FILE *fp, int N)
+{
+    long capacity = 16;
+    GRAPH *graph = new_graph(N, capacity);
+    int *weights = (int *)malloc((capacity + 1) * sizeof(int));
+    int weighted = 0; /* whether a link has a distance other than 1 */
+    struct stat status;
+    long start = ftell(fp); /* where the table starts, after the line of N */
+    char *data = NULL;
+    const char *text = "", *end = text; /* the values left to read */
+
+    if (weights == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    if (start == -1 || fstat(fileno(fp), &status) == -1)
+    {
+        printf("Input file cannot be read!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The table is read straight from the mapped file, without copying it or calling fscanf. */
+    if (status.st_size > start)
+    {
+        data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+        if (data == MAP_FAILED)
+        {
+            printf("Input file cannot be mapped in memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        posix_madvise(data, (size_t)status.st_size, POSIX_MADV_SEQUENTIAL);
+        text = data + start;
+        end = data + status.st_size;
+    }
+
+    graph->link_count = 0;
+    for (int i = 0; i < N; i++)
+    {
+        int j = 0;
+
+        graph->offsets[i] = graph->link_count;
+
+        /* The values of each row are read in order, so the links come out sorted. */
+        while (j < N)
+        {
+            int value;
+
+            while (text < end && is_space(*text))
+            {
+                text++;
+            }
+            /* Most of a large table is "0 0 0 0 ", skipped 8 bytes, 4 values, at a time. */
+            while (j + 4 <= N && end - text >= 8 && memcmp(text, "0 0 0 0 ", 8) == 0)
+            {
+                text += 8;
+                j += 4;
+            }
+            if (j == N)
+            {
+                break;
+            }
+
+            if (!scan_value(&text, end, &value))
+            {
+                printf("Input file has an invalid neighbor table!\n");
+                exit(EXIT_FAILURE);
+            }
+            /* If a value in the table is 1 or more, then city i connects with city j. */
+            if (value < 1)
+            {
+                j++;
+                continue;
+            }
+
+            if (graph->link_count == capacity)
+            {
+                capacity *= 2;
+                graph->targets = (int *)realloc(graph->targets, (capacity + 1) * sizeof(int));
+                weights = (int *)realloc(weights, (capacity + 1) * sizeof(int));
+
+                if (graph->targets == NULL || weights == NULL)
+                {
+                    printf("Error: Unable to Allocate Memory using realloc\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            weighted |= (value != 1);
+            weights[graph->link_count] = value;
+            graph->targets[graph->link_count++] = j++;
+        }
+    }
+    graph->offsets[N] = graph->link_count;
+
+    if (data != NULL)
+    {
+        munmap(data, (size_t)status.st_size);
+    }
+
+    /* A table of 0s and 1s has no distances. */
+    if (weighted)
+    {
+        graph->weights = weights;
+    }
+    else
+    {
+        free(weights);
+    }
+    return graph;
+}
+
+/** @brief Reads the values of a line of a list of links.
+ *
+ *   @param fp     the input file
+ *   @param values room for up to 4 values, more than a link has
+ *   @return the number of values of the line, or -1 if it has anything else or is too long
+ */
+static int scan_link(FILE *fp, int *values)
+{
+    char line[256];
+    const char *text = line, *end = NULL;
+    int count = 0;
+
+    if (fgets(line, sizeof(line), fp) == NULL)
+    {
+        return -1;
+    }
+    end = line + strlen(line);
+    if (strchr(line, '\n') == NULL && !feof(fp))
+    {
+        return -1;
+    }
+
+    while (count < 4 && scan_value(&text, end, &values[count]))
+    {
+        count++;
+    }
+    while (text < end && is_space(*text))
+    {
+        text++;
+    }
+    return (text == end) ? count : -1;
+}
+
+GRAPH *read_link_list(FILE *fp, int N, long link_count)
+{
+    int *sources = (int *)malloc(((size_t)link_count + 1) * sizeof(int));
+    int *targets = (int *)malloc(((size_t)link_count + 1) * sizeof(int));
+    int *weights = NULL;
+    GRAPH *graph = NULL;
+    int value_count = 0; /* number of values on the line of each link, 2 or 3 */
+
+    if (sources == NULL || targets == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (long i = 0; i < link_count; i++)
+    {
+        int values[4];
+        int count = scan_link(fp, values);
+
+        /* The first link tells whether the links have distances, and every other follows it. */
+        if (i == 0)
+        {
+            value_count = count;
+        }
+        if (i == 0 && count == 3)
+        {
+            weights = (int *)malloc(((size_t)link_count + 1) * sizeof(int));
+            if (weights == NULL)
+            {
+                printf("Error: Could not allocate memory\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        if ((count != 2 && count != 3) || count != value_count || values[0] < 0 ||
+            values[0] >= N || values[1] < 0 || values[1] >= N || (count == 3 && values[2] < 0))
+        {
+            printf("Input file has an invalid link on line %ld!\n", i + 2);
+            exit(EXIT_FAILURE);
+        }
+        sources[i] = values[0];
+        targets[i] = values[1];
+        if (weights != NULL)
+        {
+            weights[i] = values[2];
+        }
+    }
+
+    graph = build_graph(N, link_count, sources, targets, weights);
+    free(sources);
+    free(targets);
+    free(weights);
+    return graph;
+}
+
+GRAPH *read_binary_graph(FILE *fp, int weighted)
+{
+    unsigned char header[12];
+    unsigned char bytes[8];
+    int N;
+    long link_count;
+    GRAPH *graph = NULL;
+
+    if (fread(header, 1, 12, fp) != 12)
+    {
+        printf("Input file is a truncated binary graph!\n");
+        exit(EXIT_FAILURE);
+    }
+    N = (int)(header[0] | (header[1] << 8) | (header[2] << 16) | ((unsigned)header[3] << 24));
+    link_count = 0;
+    for (int b = 7; b >= 0; b--)
+    {
+        link_count = (link_count << 8) | header[4 + b];
+    }
+    if (N < 0 || link_count < 0)
+    {
+        printf("Input file has an invalid number of cities or links!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    graph = new_graph(N, link_count);
+
+    for (int i = 0; i <= N; i++)
+    {
+        if (fread(bytes, 1, 8, fp) != 8)
+        {
+            printf("Input file is a truncated binary graph!\n");
+            exit(EXIT_FAILURE);
+        }
+        graph->offsets[i] = 0;
+        for (int b = 7; b >= 0; b--)
+        {
+            graph->offsets[i] = (graph->offsets[i] << 8) | bytes[b];
+        }
+        /* The offsets need to grow from 0 to the number of links. */
+        if ((i == 0 && graph->offsets[i] != 0) ||
+            (i > 0 && graph->offsets[i] < graph->offsets[i - 1]) ||
+            (i == N && graph->offsets[i] != link_count))
+        {
+            printf("Input file has invalid offsets!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (long i = 0, city = 0; i < link_count; i++)
+    {
+        if (fread(bytes, 1, 4, fp) != 4)
+        {
+            printf("Input file is a truncated binary graph!\n");
+            exit(EXIT_FAILURE);
+        }
+        graph->targets[i] = (int)(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+                                  ((unsigned)bytes[3] << 24));
+        if (graph->targets[i] < 0 || graph->targets[i] >= N)
+        {
+            printf("Input file has an invalid link!\n");
+            exit(EXIT_FAILURE);
+        }
+
+        /* The links of each city need to be sorted and kept once, as build_graph() leaves them. */
+        while (graph->offsets[city + 1] <= i)
+        {
+            city++;
+        }
+        if (i > graph->offsets[city] && graph->targets[i] <= graph->targets[i - 1])
+        {
+            printf("Input file has unsorted or repeated links!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (weighted)
+    {
+        graph->weights = (int *)malloc(((size_t)link_count + 1) * sizeof(int));
+        if (graph->weights == NULL)
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+        for (long i = 0; i < link_count; i++)
+        {
+            if (fread(bytes, 1, 4, fp) != 4)
+            {
+                printf("Input file is a truncated binary graph!\n");
+                exit(EXIT_FAILURE);
+            }
+            graph->weights[i] = (int)(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+                                      ((unsigned)bytes[3] << 24));
+            if (graph->weights[i] < 0)
+            {
+                printf("Input file has an invalid distance!\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    return graph;
+}
+
+GRAPH *build_graph(int N, long link_count, int *sources, int *targets, int *weights)
+{
+    GRAPH *graph = new_graph(N, link_count);
+    long *next = (long *)malloc(((size_t)N + 1) * sizeof(long)); /* next free place of each city */
+    unsigned long long *links = NULL; /* each link above its distance, if there are distances */
+    long kept = 0;
+
+    if (next == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Counts the links of each city, then places each link after the ones of the cities before. */
+    memset(graph->offsets, 0, ((size_t)N + 1) * sizeof(long));
+    for (long i = 0; i < link_count; i++)
+    {
+        graph->offsets[sources[i] + 1]++;
+    }
+    for (int i = 0; i < N; i++)
+    {
+        graph->offsets[i + 1] += graph->offsets[i];
+    }
+    memcpy(next, graph->offsets, ((size_t)N + 1) * sizeof(long));
+
+    if (weights == NULL)
+    {
+        for (long i = 0; i < link_count; i++)
+        {
+            graph->targets[next[sources[i]]++] = targets[i];
+        }
+    }
+    else
+    {
+        links = (unsigned long long *)malloc(((size_t)link_count + 1) *
+                                             sizeof(unsigned long long));
+        graph->weights = (int *)malloc(((size_t)link_count + 1) * sizeof(int));
+        if (links == NULL || graph->weights == NULL)
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+        for (long i = 0; i < link_count; i++)
+        {
+            links[next[sources[i]]++] = ((unsigned long long)targets[i] << 32) |
+                                        (unsigned)weights[i];
+        }
+    }
+
+    /* Sorts the links of each city and keeps each one once, with its smallest distance first. */
+    for (int i = 0; i < N; i++)
+    {
+        long first = graph->offsets[i];
+        long count = graph->offsets[i + 1] - first;
+
+        graph->offsets[i] = kept;
+        if (links == NULL)
+        {
+            qsort(graph->targets + first, count, sizeof(int), compare_cities);
+            for (long j = 0; j < count; j++)
+            {
+                if (j == 0 || graph->targets[first + j] != graph->targets[first + j - 1])
+                {
+                    graph->targets[kept++] = graph->targets[first + j];
+                }
+            }
+            continue;
+        }
+
+        qsort(links + first, count, sizeof(unsigned long long), compare_weighted_links);
+        for (long j = 0; j < count; j++)
+        {
+            if (j == 0 || (links[first + j] >> 32) != (links[first + j - 1] >> 32))
+            {
+                graph->targets[kept] = (int)(links[first + j] >> 32);
+                graph->weights[kept++] = (int)(links[first + j] & 0xFFFFFFFFULL);
+            }
+        }
+    }
+    graph->offsets[N] = kept;
+    graph->link_count = kept;
+
+    free(links);
+    free(next);
+    return graph;
+}
+
+GRAPH *reverse_graph(GRAPH *graph)
+{
+    GRAPH *reverse = new_graph(graph->city_count, graph->link_count);
+    long *next = (long *)malloc(((size_t)graph->city_count + 1) * sizeof(long));
+
+    if (next == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    memset(reverse->offsets, 0, ((size_t)graph->city_count + 1) * sizeof(long));
+    for (long i = 0; i < graph->link_count; i++)
+    {
+        reverse->offsets[graph->targets[i] + 1]++;
+    }
+    for (int i = 0; i < graph->city_count; i++)
+    {
+        reverse->offsets[i + 1] += reverse->offsets[i];
+    }
+    memcpy(next, reverse->offsets, ((size_t)graph->city_count + 1) * sizeof(long));
+
+    if (graph->weights != NULL)
+    {
+        reverse->weights = (int *)malloc(((size_t)graph->link_count + 1) * sizeof(int));
+        if (reverse->weights == NULL)
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* The cities are visited in increasing order, so the reversed links come out sorted. */
+    for (int i = 0; i < graph->city_count; i++)
+    {
+        for (long link = graph->offsets[i]; link < graph->offsets[i + 1]; link++)
+        {
+            long place = next[graph->targets[link]]++;
+
+            reverse->targets[place] = i;
+            if (graph->weights != NULL)
+            {
+                reverse->weights[place] = graph->weights[link];
+            }
+        }
+    }
+
+    free(next);
+    return reverse;
+}
+
+/** @brief Saves bytes in a binary graph file.
+ *
+ *   @param fp    the binary graph file
+ *   @param bytes the bytes
+ *   @param count the number of bytes
+ *   @return void
+ */
+static void write_bytes(FILE *fp, const void *bytes, size_t count)
+{
+    if (fwrite(bytes, 1, count, fp) != count)
+    {
+        printf("Error: Unable to write the binary graph file\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void save_binary_graph(GRAPH *graph, char *filename)
+{
+    FILE *fp = NULL;
+    unsigned char bytes[12];
+
+    if ((fp = fopen(filename, "wb")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    write_bytes(fp, (graph->weights == NULL) ? GRAPH_MAGIC : GRAPH_WEIGHTED_MAGIC, 4);
+    for (int b = 0; b < 4; b++)
+    {
+        bytes[b] = (unsigned char)((unsigned)graph->city_count >> (8 * b));
+    }
+    for (int b = 0; b < 8; b++)
+    {
+        bytes[4 + b] = (unsigned char)((unsigned long)graph->link_count >> (8 * b));
+    }
+    write_bytes(fp, bytes, 12);
+
+    for (int i = 0; i <= graph->city_count; i++)
+    {
+        for (int b = 0; b < 8; b++)
+        {
+            bytes[b] = (unsigned char)((unsigned long)graph->offsets[i] >> (8 * b));
+        }
+        write_bytes(fp, bytes, 8);
+    }
+    for (long i = 0; i < graph->link_count; i++)
+    {
+        for (int b = 0; b < 4; b++)
+        {
+            bytes[b] = (unsigned char)((unsigned)graph->targets[i] >> (8 * b));
+        }
+        write_bytes(fp, bytes, 4);
+    }
+    for (long i = 0; graph->weights != NULL && i < graph->link_count; i++)
+    {
+        for (int b = 0; b < 4; b++)
+        {
+            bytes[b] = (unsigned char)((unsigned)graph->weights[i] >> (8 * b));
+        }
+        write_bytes(fp, bytes, 4);
+    }
+
+    printf("Saving %s...\n", filename);
+    if (fclose(fp) != 0)
+    {
+        printf("Error: Unable to write the binary graph file\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void print_neighbor_table(GRAPH *graph)
+{
+    printf("Neighbor table\n");
+
+    for (int i = 0; i < graph->city_count; i++)
+    {
+        long link = graph->offsets[i];
+
+        for (int j = 0; j < graph->city_count; j++)
+        {
+            /* The links are sorted, so the next one is the only one that can match j. */
+            if (link < graph->offsets[i + 1] && graph->targets[link] == j)
+            {
+                printf("%d ", (graph->weights == NULL) ? 1 : graph->weights[link]);
+                link++;
+            }
+            else
+            {
+                printf("0 ");
+            }
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+void free_graph(GRAPH *graph)
+{
+    free(graph->offsets);
+    free(graph->targets);
+    free(graph->weights);
+    free(graph);
+}
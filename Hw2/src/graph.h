@@ -0,0 +1,133 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief The first bytes of a binary graph file. */
+#define GRAPH_MAGIC "CLNK"
+
+/** @brief The first bytes of a binary graph file whose links have distances. */
+#define GRAPH_WEIGHTED_MAGIC "CLNW"
+
+/** @brief Represents the links between the cities in compressed sparse row form.
+ *
+ *   The cities city i links to are targets[offsets[i]] to targets[offsets[i + 1] - 1],
+ *   in increasing order and without repetitions. Memory grows with the number of links
+ *   instead of the number of pairs of cities. The distance of each link is next to it in
+ *   weights, if the links have distances.
+ */
+typedef struct
+{
+    int city_count;  /* number of cities */
+    long link_count; /* number of links */
+    long *offsets;   /* where the links of each city start in targets, city_count + 1 of them */
+    int *targets;    /* the city each link goes to */
+    int *weights;    /* the distance of each link, or NULL if every link has distance 1 */
+} GRAPH;
+
+/** @brief Reads the links between the cities from the specified input file.
+ *
+ *   Three formats are recognized:
+ *   - a neighbor table: N on the first line, followed by N rows of N values, where 1 means
+ *     a link from the city of the row to the city of the column. A value above 1 is a link
+ *     with that distance. The table is printed in the console if print_table is 1.
+ *   - a list of links: "N M" on the first line, followed by M lines "u v" for a link from
+ *     city u to city v, or "u v w" for a link with distance w, 0 or more.
+ *   - a binary graph file, as saved by save_binary_graph().
+ *
+ *   The program is terminated if the file cannot be read or has invalid values.
+ *
+ *   @param filename    the file to read the links from
+ *   @param print_table 1 to print a neighbor table in the console, or 0
+ *   @return the graph of the links
+ */
+GRAPH *read_graph(char *filename, int print_table);
+
+/** @brief Reads a neighbor table after its size.
+ *
+ *   The file is mapped in memory and its values are scanned by hand instead of with
+ *   fscanf(), skipping runs of zeros 4 values at a time, so a large table is read about as
+ *   fast as the disk gives it.
+ *
+ *   @param fp the input file, positioned after N
+ *   @param N  the number of cities
+ *   @return the graph of the links
+ */
+GRAPH *read_neighbor_table(FILE *fp, int N);
+
+/** @brief Reads a list of links after its first line.
+ *
+ *   Each link is on its own line. The first link tells whether the links have distances,
+ *   and a line with another number of values than it is an invalid link.
+ *
+ *   @param fp         the input file, positioned after N and M
+ *   @param N          the number of cities
+ *   @param link_count the number of links, M
+ *   @return the graph of the links
+ */
+GRAPH *read_link_list(FILE *fp, int N, long link_count);
+
+/** @brief Reads a binary graph file after GRAPH_MAGIC or GRAPH_WEIGHTED_MAGIC.
+ *
+ *   The links of each city need to be sorted by target, with no link repeated, as
+ *   save_binary_graph() saves them. The program is terminated otherwise.
+ *
+ *   @param fp       the input file, positioned after the magic
+ *   @param weighted 1 if the file started with GRAPH_WEIGHTED_MAGIC or 0 otherwise
+ *   @return the graph of the links
+ */
+GRAPH *read_binary_graph(FILE *fp, int weighted);
+
+/** @brief Builds a graph from links given in any order.
+ *
+ *   Repeated links are kept once, with their smallest distance.
+ *
+ *   @param N          the number of cities
+ *   @param link_count the number of links
+ *   @param sources    the city each link starts from
+ *   @param targets    the city each link goes to
+ *   @param weights    the distance of each link, or NULL if every link has distance 1
+ *   @return the graph of the links
+ */
+GRAPH *build_graph(int N, long link_count, int *sources, int *targets, int *weights);
+
+/** @brief Builds the graph with every link of a graph turned around.
+ *
+ *   @param graph the graph of the links
+ *   @return the graph with a link from city v to city u for each link from u to v
+ */
+GRAPH *reverse_graph(GRAPH *graph);
+
+/** @brief Saves a graph as a binary graph file.
+ *
+ *   The file is GRAPH_MAGIC, N as a 32-bit and M as a 64-bit little-endian number, the N + 1
+ *   offsets as 64-bit and the M targets as 32-bit little-endian numbers. If the links have
+ *   distances, the file starts with GRAPH_WEIGHTED_MAGIC instead and the M distances
+ *   follow as 32-bit little-endian numbers. The program is terminated if the file cannot be
+ *   written.
+ *
+ *   @param graph    the graph to save
+ *   @param filename the name of the binary graph file
+ *   @return void
+ */
+void save_binary_graph(GRAPH *graph, char *filename);
+
+/** @brief Prints the links of a graph as a neighbor table.
+ *
+ *   Each link is printed as its distance, 1 if the links have no distances.
+ *
+ *   @param graph the graph to print
+ *   @return void
+ */
+void print_neighbor_table(GRAPH *graph);
+
+/** @brief Frees up the graph from memory.
+ *
+ *   @param graph the graph
+ *   @return void
+ */
+void free_graph(GRAPH *graph);
+
+#endif
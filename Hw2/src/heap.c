@@ -0,0 +1,129 @@
+#include "heap.h"
+
+PAIRING_HEAP *new_pairing_heap(int city_count)
+{
+    PAIRING_HEAP *heap = (PAIRING_HEAP *)malloc(sizeof(PAIRING_HEAP));
+
+    if (heap == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    heap->root = -1;
+    heap->keys = (long long *)malloc(((size_t)city_count + 1) * sizeof(long long));
+    heap->child = (int *)malloc(((size_t)city_count + 1) * sizeof(int));
+    heap->sibling = (int *)malloc(((size_t)city_count + 1) * sizeof(int));
+    heap->previous = (int *)malloc(((size_t)city_count + 1) * sizeof(int));
+    heap->pairs = (int *)malloc(((size_t)city_count + 1) * sizeof(int));
+
+    if (heap->keys == NULL || heap->child == NULL || heap->sibling == NULL ||
+        heap->previous == NULL || heap->pairs == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    return heap;
+}
+
+/** @brief Joins two trees, the one with the larger root becoming the first child of the other.
+ *
+ *   @param heap the heap
+ *   @param a    the root of the first tree, without siblings
+ *   @param b    the root of the second tree, without siblings
+ *   @return the root of the joined tree
+ */
+static int link_trees(PAIRING_HEAP *heap, int a, int b)
+{
+    if (heap->keys[b] < heap->keys[a])
+    {
+        int swap = a;
+
+        a = b;
+        b = swap;
+    }
+
+    heap->sibling[b] = heap->child[a];
+    if (heap->child[a] != -1)
+    {
+        heap->previous[heap->child[a]] = b;
+    }
+    heap->previous[b] = a;
+    heap->child[a] = b;
+    return a;
+}
+
+void push_heap(PAIRING_HEAP *heap, int city, long long key)
+{
+    heap->keys[city] = key;
+    heap->child[city] = heap->sibling[city] = heap->previous[city] = -1;
+    heap->root = (heap->root == -1) ? city : link_trees(heap, heap->root, city);
+}
+
+void decrease_key(PAIRING_HEAP *heap, int city, long long key)
+{
+    int previous = heap->previous[city];
+
+    heap->keys[city] = key;
+    if (city == heap->root)
+    {
+        return;
+    }
+
+    /* Cuts the city out of the list of children it is in. */
+    if (heap->child[previous] == city)
+    {
+        heap->child[previous] = heap->sibling[city];
+    }
+    else
+    {
+        heap->sibling[previous] = heap->sibling[city];
+    }
+    if (heap->sibling[city] != -1)
+    {
+        heap->previous[heap->sibling[city]] = previous;
+    }
+    heap->sibling[city] = heap->previous[city] = -1;
+    heap->root = link_trees(heap, heap->root, city);
+}
+
+int pop_heap(PAIRING_HEAP *heap)
+{
+    int top = heap->root;
+    int child = heap->child[top];
+    int count = 0;
+
+    /* First pass: joins the children two by two, from the first to the last. */
+    while (child != -1)
+    {
+        int first = child, second = heap->sibling[child];
+
+        child = (second == -1) ? -1 : heap->sibling[second];
+        heap->sibling[first] = heap->previous[first] = -1;
+        if (second != -1)
+        {
+            heap->sibling[second] = heap->previous[second] = -1;
+            first = link_trees(heap, first, second);
+        }
+        heap->pairs[count++] = first;
+    }
+
+    /* Second pass: joins the pairs into one tree, from the last to the first. */
+    heap->root = (count == 0) ? -1 : heap->pairs[count - 1];
+    for (int i = count - 2; i >= 0; i--)
+    {
+        heap->root = link_trees(heap, heap->pairs[i], heap->root);
+    }
+    heap->child[top] = -1;
+    return top;
+}
+
+void free_pairing_heap(PAIRING_HEAP *heap)
+{
+    free(heap->keys);
+    free(heap->child);
+    free(heap->sibling);
+    free(heap->previous);
+    free(heap->pairs);
+    free(heap);
+}
@@ -0,0 +1,66 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Represents a pairing heap of cities, ordered by a key.
+ *
+ *   The heap is a tree in which every city has a key no smaller than its parent's. The
+ *   children of a city are a list from its first child through the siblings. Adding a city
+ *   and lowering its key take constant time, and taking the city with the smallest key
+ *   pairs up its children in two passes, in logarithmic time on average.
+ */
+typedef struct
+{
+    int root;           /* the city with the smallest key, or -1 if the heap is empty */
+    long long *keys;    /* the key of each city in the heap */
+    int *child;         /* the first child of each city, or -1 */
+    int *sibling;       /* the next sibling of each city, or -1 */
+    int *previous;      /* the previous sibling of each city, its parent if it is the first */
+    int *pairs;         /* room for the children paired up by pop_heap() */
+} PAIRING_HEAP;
+
+/** @brief Creates an empty heap.
+ *
+ *   @param city_count the number of cities, which are numbered from 0
+ *   @return the new heap
+ */
+PAIRING_HEAP *new_pairing_heap(int city_count);
+
+/** @brief Adds a city that is not in the heap.
+ *
+ *   @param heap the heap
+ *   @param city the city
+ *   @param key  the key of the city
+ *   @return void
+ */
+void push_heap(PAIRING_HEAP *heap, int city, long long key);
+
+/** @brief Lowers the key of a city in the heap.
+ *
+ *   The city is cut from its parent with its children and paired with the root.
+ *
+ *   @param heap the heap
+ *   @param city the city
+ *   @param key  the new key, no larger than the old one
+ *   @return void
+ */
+void decrease_key(PAIRING_HEAP *heap, int city, long long key);
+
+/** @brief Takes the city with the smallest key out of the heap.
+ *
+ *   @param heap the heap, not empty
+ *   @return the city
+ */
+int pop_heap(PAIRING_HEAP *heap);
+
+/** @brief Frees up the heap from memory.
+ *
+ *   @param heap the heap
+ *   @return void
+ */
+void free_pairing_heap(PAIRING_HEAP *heap);
+
+#endif
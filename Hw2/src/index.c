@@ -0,0 +1,383 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "index.h"
+
+/** @brief Rounds a size up to a multiple of 8 bytes.
+ *
+ *   @param size the size
+ *   @return the rounded size
+ */
+static long long align_size(long long size)
+{
+    return (size + 7) / 8 * 8;
+}
+
+/** @brief Saves an array and pads it to a multiple of 8 bytes.
+ *
+ *   @param fp    the index file
+ *   @param data  the array
+ *   @param bytes the size of the array
+ *   @return void
+ */
+static void write_section(FILE *fp, const void *data, long long bytes)
+{
+    static const char padding[8] = {0};
+
+    if (bytes > 0 && fwrite(data, 1, (size_t)bytes, fp) != (size_t)bytes)
+    {
+        printf("Error: Unable to write the index file\n");
+        exit(EXIT_FAILURE);
+    }
+    if (fwrite(padding, 1, (size_t)(align_size(bytes) - bytes), fp) !=
+        (size_t)(align_size(bytes) - bytes))
+    {
+        printf("Error: Unable to write the index file\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void save_index(GRAPH *graph, char *filename)
+{
+    GRAPH *reverse = reverse_graph(graph);
+    CONDENSATION *condensation = condense_graph(graph);
+    INDEX_HEADER header;
+    const void *data[INDEX_SECTIONS];
+    long long bytes[INDEX_SECTIONS];
+    long long position = align_size(sizeof(INDEX_HEADER));
+    long long N = graph->city_count, C = condensation->component_count;
+    LABELS *labels = NULL;
+    FILE *fp = NULL;
+
+    if (C <= MAX_CLOSURE_COMPONENTS)
+    {
+        build_condensed_closure(condensation, graph);
+    }
+    else
+    {
+        labels = build_labels(condensation, graph);
+    }
+
+    memset(data, 0, sizeof(data));
+    memset(bytes, 0, sizeof(bytes));
+    data[SECTION_OFFSETS] = graph->offsets;
+    bytes[SECTION_OFFSETS] = (N + 1) * (long long)sizeof(long);
+    data[SECTION_TARGETS] = graph->targets;
+    bytes[SECTION_TARGETS] = graph->link_count * (long long)sizeof(int);
+    data[SECTION_REVERSE_OFFSETS] = reverse->offsets;
+    bytes[SECTION_REVERSE_OFFSETS] = (N + 1) * (long long)sizeof(long);
+    data[SECTION_REVERSE_TARGETS] = reverse->targets;
+    bytes[SECTION_REVERSE_TARGETS] = reverse->link_count * (long long)sizeof(int);
+    if (graph->weights != NULL)
+    {
+        data[SECTION_WEIGHTS] = graph->weights;
+        bytes[SECTION_WEIGHTS] = graph->link_count * (long long)sizeof(int);
+    }
+    data[SECTION_COMPONENT] = condensation->component;
+    bytes[SECTION_COMPONENT] = N * (long long)sizeof(int);
+    data[SECTION_FIRST_MEMBER] = condensation->first_member;
+    bytes[SECTION_FIRST_MEMBER] = (C + 1) * (long long)sizeof(long);
+    data[SECTION_MEMBERS] = condensation->members;
+    bytes[SECTION_MEMBERS] = N * (long long)sizeof(int);
+    if (labels == NULL)
+    {
+        data[SECTION_REACH] = condensation->reach->bits;
+        bytes[SECTION_REACH] = C * condensation->reach->words *
+                               (long long)sizeof(unsigned long long);
+    }
+    else
+    {
+        data[SECTION_OUT_OFFSETS] = labels->out_offsets;
+        bytes[SECTION_OUT_OFFSETS] = (C + 1) * (long long)sizeof(long);
+        data[SECTION_OUT_LABELS] = labels->out_labels;
+        bytes[SECTION_OUT_LABELS] = labels->out_offsets[C] * (long long)sizeof(int);
+        data[SECTION_IN_OFFSETS] = labels->in_offsets;
+        bytes[SECTION_IN_OFFSETS] = (C + 1) * (long long)sizeof(long);
+        data[SECTION_IN_LABELS] = labels->in_labels;
+        bytes[SECTION_IN_LABELS] = labels->in_offsets[C] * (long long)sizeof(int);
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, 4);
+    header.version = INDEX_VERSION;
+    header.byte_order = INDEX_BYTE_ORDER;
+    header.long_size = sizeof(long);
+    header.city_count = N;
+    header.link_count = graph->link_count;
+    header.component_count = C;
+    header.out_label_count = (labels == NULL) ? 0 : labels->out_offsets[C];
+    header.in_label_count = (labels == NULL) ? 0 : labels->in_offsets[C];
+    header.weight_count = (graph->weights == NULL) ? 0 : graph->link_count;
+    for (int s = 0; s < INDEX_SECTIONS; s++)
+    {
+        header.sections[s] = position;
+        position += align_size(bytes[s]);
+    }
+
+    if ((fp = fopen(filename, "wb")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    write_section(fp, &header, sizeof(header));
+    for (int s = 0; s < INDEX_SECTIONS; s++)
+    {
+        write_section(fp, data[s], bytes[s]);
+    }
+
+    printf("Saving %s...\n", filename);
+    if (fclose(fp) != 0)
+    {
+        printf("Error: Unable to write the index file\n");
+        exit(EXIT_FAILURE);
+    }
+    if (labels != NULL)
+    {
+        free_labels(labels);
+    }
+    free_condensation(condensation);
+    free_graph(reverse);
+}
+
+/** @brief Gets an array of the mapped index file, checking that it is inside the file.
+ *
+ *   @param index   the index, with data and size set
+ *   @param header  the header of the index file
+ *   @param section the array
+ *   @param bytes   the size of the array
+ *   @return the start of the array
+ */
+static void *get_section(INDEX *index, INDEX_HEADER *header, int section, long long bytes)
+{
+    long long start = header->sections[section];
+
+    if (start < (long long)sizeof(INDEX_HEADER) || start % 8 != 0 || bytes < 0 ||
+        start + bytes > (long long)index->size)
+    {
+        printf("Index file is damaged!\n");
+        exit(EXIT_FAILURE);
+    }
+    return (char *)index->data + start;
+}
+
+/** @brief Checks that an array of offsets starts at 0, never goes down and ends at a total.
+ *
+ *   @param offsets the array, with count + 1 offsets
+ *   @param count   the number of ranges
+ *   @param total   the last offset
+ *   @return 1 if the offsets are valid or 0 otherwise
+ */
+static int are_valid_offsets(const long *offsets, long long count, long long total)
+{
+    if (offsets[0] != 0 || offsets[count] != total)
+    {
+        return 0;
+    }
+    for (long long i = 0; i < count; i++)
+    {
+        if (offsets[i] > offsets[i + 1])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/** @brief Checks that every number of an array is from 0 to a limit, the limit excluded.
+ *
+ *   @param numbers the array
+ *   @param count   the number of numbers
+ *   @param limit   the limit
+ *   @return 1 if the numbers are valid or 0 otherwise
+ */
+static int are_valid_numbers(const int *numbers, long long count, long long limit)
+{
+    for (long long i = 0; i < count; i++)
+    {
+        if (numbers[i] < 0 || numbers[i] >= limit)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+INDEX *open_index(char *filename)
+{
+    INDEX *index = (INDEX *)malloc(sizeof(INDEX));
+    INDEX_HEADER *header = NULL;
+    struct stat status;
+    long long N = 0, M = 0, C = 0, out_count = 0, in_count = 0;
+    int fd = -1;
+
+    if (index == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fd = open(filename, O_RDONLY)) == -1 || fstat(fd, &status) == -1)
+    {
+        printf("Index file cannot be read!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (status.st_size < (off_t)sizeof(INDEX_HEADER))
+    {
+        printf("Index file is damaged!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    index->size = (size_t)status.st_size;
+    index->data = mmap(NULL, index->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (index->data == MAP_FAILED)
+    {
+        printf("Index file cannot be mapped in memory!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    header = (INDEX_HEADER *)index->data;
+    if (memcmp(header->magic, INDEX_MAGIC, 4) != 0)
+    {
+        printf("\"%s\" is not an index file!\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    if (header->version != INDEX_VERSION)
+    {
+        printf("Index file has version %u, this program reads version %d!\n", header->version,
+               INDEX_VERSION);
+        exit(EXIT_FAILURE);
+    }
+    if (header->byte_order != INDEX_BYTE_ORDER || header->long_size != sizeof(long))
+    {
+        printf("Index file was built on another kind of machine!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    N = header->city_count;
+    M = header->link_count;
+    C = header->component_count;
+    out_count = header->out_label_count;
+    in_count = header->in_label_count;
+    if (N < 0 || N > 2147483647LL || M < 0 || C < 0 || C > N || out_count < 0 || in_count < 0 ||
+        (header->weight_count != 0 && header->weight_count != M))
+    {
+        printf("Index file is damaged!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    index->graph = (GRAPH *)malloc(sizeof(GRAPH));
+    index->reverse = (GRAPH *)malloc(sizeof(GRAPH));
+    index->condensation = (CONDENSATION *)malloc(sizeof(CONDENSATION));
+    if (index->graph == NULL || index->reverse == NULL || index->condensation == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The structures point into the mapped file, so nothing is copied. */
+    index->graph->city_count = index->reverse->city_count = (int)N;
+    index->graph->link_count = index->reverse->link_count = (long)M;
+    index->graph->offsets = (long *)get_section(index, header, SECTION_OFFSETS,
+                                                (N + 1) * (long long)sizeof(long));
+    index->graph->targets = (int *)get_section(index, header, SECTION_TARGETS,
+                                               M * (long long)sizeof(int));
+    index->reverse->offsets = (long *)get_section(index, header, SECTION_REVERSE_OFFSETS,
+                                                  (N + 1) * (long long)sizeof(long));
+    index->reverse->targets = (int *)get_section(index, header, SECTION_REVERSE_TARGETS,
+                                                 M * (long long)sizeof(int));
+    /* The reversed links are only searched by number of links, so they need no distances. */
+    index->graph->weights = index->reverse->weights = NULL;
+    if (header->weight_count != 0)
+    {
+        index->graph->weights = (int *)get_section(index, header, SECTION_WEIGHTS,
+                                                   M * (long long)sizeof(int));
+    }
+
+    index->condensation->city_count = (int)N;
+    index->condensation->component_count = (int)C;
+    index->condensation->component = (int *)get_section(index, header, SECTION_COMPONENT,
+                                                        N * (long long)sizeof(int));
+    index->condensation->first_member = (long *)get_section(index, header, SECTION_FIRST_MEMBER,
+                                                            (C + 1) * (long long)sizeof(long));
+    index->condensation->members = (int *)get_section(index, header, SECTION_MEMBERS,
+                                                      N * (long long)sizeof(int));
+    index->condensation->reach = NULL;
+    index->labels = NULL;
+
+    if (C <= MAX_CLOSURE_COMPONENTS)
+    {
+        index->condensation->reach = (BIT_MATRIX *)malloc(sizeof(BIT_MATRIX));
+        if (index->condensation->reach == NULL)
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+        index->condensation->reach->size = (int)C;
+        index->condensation->reach->words = (int)((C + WORD_BITS - 1) / WORD_BITS);
+        index->condensation->reach->bits = (unsigned long long *)get_section(
+            index, header, SECTION_REACH,
+            C * index->condensation->reach->words * (long long)sizeof(unsigned long long));
+    }
+    else
+    {
+        index->labels = (LABELS *)malloc(sizeof(LABELS));
+        if (index->labels == NULL)
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+        index->labels->component_count = (int)C;
+        index->labels->out_offsets = (long *)get_section(index, header, SECTION_OUT_OFFSETS,
+                                                         (C + 1) * (long long)sizeof(long));
+        index->labels->out_labels = (int *)get_section(index, header, SECTION_OUT_LABELS,
+                                                       out_count * (long long)sizeof(int));
+        index->labels->in_offsets = (long *)get_section(index, header, SECTION_IN_OFFSETS,
+                                                        (C + 1) * (long long)sizeof(long));
+        index->labels->in_labels = (int *)get_section(index, header, SECTION_IN_LABELS,
+                                                      in_count * (long long)sizeof(int));
+        /* The landmarks are components, by rank. */
+        if (!are_valid_offsets(index->labels->out_offsets, C, out_count) ||
+            !are_valid_offsets(index->labels->in_offsets, C, in_count) ||
+            !are_valid_numbers(index->labels->out_labels, out_count, C) ||
+            !are_valid_numbers(index->labels->in_labels, in_count, C))
+        {
+            printf("Index file is damaged!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /*
+     * Every array is checked once, so that no city, link or component is out of range later,
+     * and no distance is negative.
+     */
+    if (!are_valid_offsets(index->graph->offsets, N, M) ||
+        !are_valid_offsets(index->reverse->offsets, N, M) ||
+        !are_valid_offsets(index->condensation->first_member, C, N) ||
+        !are_valid_numbers(index->graph->targets, M, N) ||
+        !are_valid_numbers(index->reverse->targets, M, N) ||
+        !are_valid_numbers(index->condensation->component, N, C) ||
+        !are_valid_numbers(index->condensation->members, N, N) ||
+        (index->graph->weights != NULL &&
+         !are_valid_numbers(index->graph->weights, M, 2147483647LL + 1)))
+    {
+        printf("Index file is damaged!\n");
+        exit(EXIT_FAILURE);
+    }
+    return index;
+}
+
+void close_index(INDEX *index)
+{
+    /* Only the structures were allocated, their arrays are in the mapped file. */
+    free(index->graph);
+    free(index->reverse);
+    free(index->condensation->reach);
+    free(index->condensation);
+    free(index->labels);
+    munmap(index->data, index->size);
+    free(index);
+}
@@ -0,0 +1,103 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bit_matrix.h"
+#include "graph.h"
+#include "scc.h"
+#include "labels.h"
+
+/** @brief The first bytes of an index file. */
+#define INDEX_MAGIC "CLIX"
+
+/** @brief Version of the index file layout, increased whenever the layout changes. */
+#define INDEX_VERSION 3
+
+/** @brief Written as a number, to tell whether the index was built with the same byte order. */
+#define INDEX_BYTE_ORDER 0x01020304u
+
+/** @brief The arrays of an index file, in the order they are saved. */
+#define SECTION_OFFSETS 0         /* offsets of the links */
+#define SECTION_TARGETS 1         /* targets of the links */
+#define SECTION_REVERSE_OFFSETS 2 /* offsets of the reversed links */
+#define SECTION_REVERSE_TARGETS 3 /* targets of the reversed links */
+#define SECTION_COMPONENT 4       /* component of each city */
+#define SECTION_FIRST_MEMBER 5    /* where the cities of each component start */
+#define SECTION_MEMBERS 6         /* cities of each component */
+#define SECTION_REACH 7           /* transitive closure of the components */
+#define SECTION_OUT_OFFSETS 8     /* where the out-labels of each component start */
+#define SECTION_OUT_LABELS 9      /* landmarks each component reaches */
+#define SECTION_IN_OFFSETS 10     /* where the in-labels of each component start */
+#define SECTION_IN_LABELS 11      /* landmarks that reach each component */
+#define SECTION_WEIGHTS 12        /* distances of the links, if they have distances */
+#define INDEX_SECTIONS 13
+
+/** @brief The start of an index file.
+ *
+ *   The arrays follow, each starting at a multiple of 8 bytes, as they are in memory. The
+ *   transitive closure of the components is saved if there are at most
+ *   MAX_CLOSURE_COMPONENTS of them, and their labels otherwise, the other sections being
+ *   empty. The index can only be used on a machine with the same byte order and size of long.
+ */
+typedef struct
+{
+    char magic[4];                      /* INDEX_MAGIC */
+    unsigned int version;               /* INDEX_VERSION */
+    unsigned int byte_order;            /* INDEX_BYTE_ORDER */
+    unsigned int long_size;             /* sizeof(long) */
+    long long city_count;
+    long long link_count;
+    long long component_count;
+    long long out_label_count;          /* 0 if the transitive closure is saved */
+    long long in_label_count;           /* 0 if the transitive closure is saved */
+    long long weight_count;             /* link_count if the links have distances, 0 otherwise */
+    long long sections[INDEX_SECTIONS]; /* where each array starts in the file */
+} INDEX_HEADER;
+
+/** @brief Represents an index file mapped in memory.
+ *
+ *   The graphs and the components point straight into the mapped file, which is read-only
+ *   and shared with every other program that maps the same file.
+ */
+typedef struct
+{
+    void *data;                 /* the mapped file */
+    size_t size;                /* the size of the file */
+    GRAPH *graph;               /* the links between the cities */
+    GRAPH *reverse;             /* the links reversed */
+    CONDENSATION *condensation; /* the components, with their transitive closure or not */
+    LABELS *labels;             /* the labels of the components without closure, or NULL */
+} INDEX;
+
+/** @brief Builds the index of a graph and saves it.
+ *
+ *   The index has the links with their distances, the reversed links for the path searches
+ *   and the transitive closure of the strongly connected components, or their labels if
+ *   there are too many components for the closure.
+ *
+ *   @param graph    the links between the cities
+ *   @param filename the name of the index file
+ *   @return void
+ */
+void save_index(GRAPH *graph, char *filename);
+
+/** @brief Maps an index file in memory.
+ *
+ *   The program is terminated if the file is not an index this program can use, or if an
+ *   array has a city, a link or a component out of range.
+ *
+ *   @param filename the name of the index file
+ *   @return the index
+ */
+INDEX *open_index(char *filename);
+
+/** @brief Unmaps an index file and frees up the index from memory.
+ *
+ *   @param index the index
+ *   @return void
+ */
+void close_index(INDEX *index);
+
+#endif
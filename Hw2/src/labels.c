@@ -0,0 +1,278 @@
+#include "labels.h"
+
+/** @brief The landmarks of one component while the labels are built. */
+typedef struct
+{
+    int *items;   /* the landmarks, by rank */
+    int count;    /* the number of landmarks */
+    int capacity; /* the number of landmarks items has room for */
+} LABEL_LIST;
+
+/** @brief A component with the score it is ranked by. */
+typedef struct
+{
+    long long score;
+    int component;
+} RANKED_COMPONENT;
+
+/** @brief Compares the scores of two components, the highest first.
+ *
+ *   @param a the first component
+ *   @param b the second component
+ *   @return less than, equal to or greater than 0 if a comes before, with or after b
+ */
+static int compare_ranked(const void *a, const void *b)
+{
+    const RANKED_COMPONENT *x = (const RANKED_COMPONENT *)a, *y = (const RANKED_COMPONENT *)b;
+
+    if (x->score != y->score)
+    {
+        return (x->score > y->score) ? -1 : 1;
+    }
+    return (x->component > y->component) - (x->component < y->component);
+}
+
+/** @brief Adds a landmark at the end of a list.
+ *
+ *   @param list the list
+ *   @param rank the rank of the landmark
+ *   @return void
+ */
+static void add_label(LABEL_LIST *list, int rank)
+{
+    if (list->count == list->capacity)
+    {
+        list->capacity = (list->capacity == 0) ? 4 : list->capacity * 2;
+        list->items = (int *)realloc(list->items, (size_t)list->capacity * sizeof(int));
+        if (list->items == NULL)
+        {
+            printf("Error: Unable to Allocate Memory using realloc\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    list->items[list->count++] = rank;
+}
+
+/** @brief Checks whether two sorted lists of landmarks have one in common.
+ *
+ *   @param a       the first list
+ *   @param a_count the length of the first list
+ *   @param b       the second list
+ *   @param b_count the length of the second list
+ *   @return 1 if a landmark is in both lists or 0 otherwise
+ */
+static int share_landmark(const int *a, long a_count, const int *b, long b_count)
+{
+    long i = 0, j = 0;
+
+    while (i < a_count && j < b_count)
+    {
+        if (a[i] == b[j])
+        {
+            return 1;
+        }
+        if (a[i] < b[j])
+        {
+            i++;
+        }
+        else
+        {
+            j++;
+        }
+    }
+    return 0;
+}
+
+/** @brief Adds a landmark to the labels of the components it finds with a pruned search.
+ *
+ *   The search is the same forward and backward: forward, links are the links between the
+ *   components, labels the in-labels and own the out-labels of the landmark, and the other
+ *   way around backward. A pair already answered by a landmark of a higher rank is neither
+ *   labeled nor searched past.
+ *
+ *   @param links    the links to follow
+ *   @param landmark the component the search starts from
+ *   @param rank     the rank of the landmark
+ *   @param stamp    the number of this search, different for every search
+ *   @param own      the labels of the landmark the found components are checked against
+ *   @param labels   the labels to add the landmark to
+ *   @param visited  the number of the last search that found each component
+ *   @param queue    room for a queue of all the components
+ *   @return void
+ */
+static void label_from(GRAPH *links, int landmark, int rank, long stamp, LABEL_LIST *own,
+                       LABEL_LIST *labels, long *visited, int *queue)
+{
+    int head = 0, tail = 0;
+
+    queue[tail++] = landmark;
+    visited[landmark] = stamp;
+
+    while (head < tail)
+    {
+        int component = queue[head++];
+
+        if (component != landmark && share_landmark(own->items, own->count,
+                                                    labels[component].items,
+                                                    labels[component].count))
+        {
+            continue;
+        }
+        add_label(&labels[component], rank);
+
+        for (long l = links->offsets[component]; l < links->offsets[component + 1]; l++)
+        {
+            int next = links->targets[l];
+
+            if (visited[next] != stamp)
+            {
+                visited[next] = stamp;
+                queue[tail++] = next;
+            }
+        }
+    }
+}
+
+/** @brief Packs the lists of landmarks of all the components one after the other.
+ *
+ *   The lists are freed.
+ *
+ *   @param lists   the landmarks of each component
+ *   @param C       the number of components
+ *   @param offsets where the landmarks of each component start, set here
+ *   @param labels  all the landmarks, set here
+ *   @return void
+ */
+static void pack_labels(LABEL_LIST *lists, int C, long **offsets, int **labels)
+{
+    long total = 0;
+
+    *offsets = (long *)malloc(((size_t)C + 1) * sizeof(long));
+    if (*offsets == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < C; c++)
+    {
+        (*offsets)[c] = total;
+        total += lists[c].count;
+    }
+    (*offsets)[C] = total;
+
+    *labels = (int *)malloc(((size_t)total + 1) * sizeof(int));
+    if (*labels == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < C; c++)
+    {
+        memcpy(*labels + (*offsets)[c], lists[c].items, (size_t)lists[c].count * sizeof(int));
+        free(lists[c].items);
+    }
+}
+
+LABELS *build_labels(CONDENSATION *condensation, GRAPH *graph)
+{
+    int C = condensation->component_count;
+    LABELS *labels = (LABELS *)malloc(sizeof(LABELS));
+    int *sources = (int *)malloc(((size_t)graph->link_count + 1) * sizeof(int));
+    int *targets = (int *)malloc(((size_t)graph->link_count + 1) * sizeof(int));
+    RANKED_COMPONENT *ranked = (RANKED_COMPONENT *)malloc(((size_t)C + 1) *
+                                                          sizeof(RANKED_COMPONENT));
+    LABEL_LIST *out_lists = (LABEL_LIST *)calloc((size_t)C + 1, sizeof(LABEL_LIST));
+    LABEL_LIST *in_lists = (LABEL_LIST *)calloc((size_t)C + 1, sizeof(LABEL_LIST));
+    long *visited = (long *)malloc(((size_t)C + 1) * sizeof(long));
+    int *queue = (int *)malloc(((size_t)C + 1) * sizeof(int));
+    GRAPH *dag = NULL, *reverse = NULL;
+    long link_count = 0;
+
+    if (labels == NULL || sources == NULL || targets == NULL || ranked == NULL ||
+        out_lists == NULL || in_lists == NULL || visited == NULL || queue == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The links between different components, each kept once. */
+    for (int city = 0; city < graph->city_count; city++)
+    {
+        int from = condensation->component[city];
+
+        for (long l = graph->offsets[city]; l < graph->offsets[city + 1]; l++)
+        {
+            int to = condensation->component[graph->targets[l]];
+
+            if (from != to)
+            {
+                sources[link_count] = from;
+                targets[link_count++] = to;
+            }
+        }
+    }
+    dag = build_graph(C, link_count, sources, targets, NULL);
+    reverse = reverse_graph(dag);
+    free(sources);
+    free(targets);
+
+    for (int c = 0; c < C; c++)
+    {
+        ranked[c].score = (long long)(dag->offsets[c + 1] - dag->offsets[c] + 1) *
+                          (reverse->offsets[c + 1] - reverse->offsets[c] + 1);
+        ranked[c].component = c;
+        visited[c] = -1;
+    }
+    qsort(ranked, (size_t)C, sizeof(RANKED_COMPONENT), compare_ranked);
+
+    for (int rank = 0; rank < C; rank++)
+    {
+        int landmark = ranked[rank].component;
+
+        label_from(dag, landmark, rank, 2L * rank, &out_lists[landmark], in_lists, visited,
+                   queue);
+        label_from(reverse, landmark, rank, 2L * rank + 1, &in_lists[landmark], out_lists,
+                   visited, queue);
+    }
+
+    labels->component_count = C;
+    pack_labels(out_lists, C, &labels->out_offsets, &labels->out_labels);
+    pack_labels(in_lists, C, &labels->in_offsets, &labels->in_labels);
+
+    free_graph(dag);
+    free_graph(reverse);
+    free(ranked);
+    free(out_lists);
+    free(in_lists);
+    free(visited);
+    free(queue);
+    return labels;
+}
+
+int labels_reach(LABELS *labels, CONDENSATION *condensation, int from, int to)
+{
+    int c = condensation->component[from], d = condensation->component[to];
+
+    if (from == to)
+    {
+        return 0;
+    }
+    /* Every component has itself as a landmark, so only the size tells whether it loops. */
+    if (c == d)
+    {
+        return condensation->first_member[c + 1] - condensation->first_member[c] > 1;
+    }
+    return share_landmark(labels->out_labels + labels->out_offsets[c],
+                          labels->out_offsets[c + 1] - labels->out_offsets[c],
+                          labels->in_labels + labels->in_offsets[d],
+                          labels->in_offsets[d + 1] - labels->in_offsets[d]);
+}
+
+void free_labels(LABELS *labels)
+{
+    free(labels->out_offsets);
+    free(labels->out_labels);
+    free(labels->in_offsets);
+    free(labels->in_labels);
+    free(labels);
+}
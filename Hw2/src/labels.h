@@ -0,0 +1,59 @@
+#ifndef LABELS_H
+#define LABELS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "graph.h"
+#include "scc.h"
+
+/** @brief Represents a 2-hop labeling of the graph of the strongly connected components.
+ *
+ *   Every component gets the landmarks it reaches and the landmarks that reach it, a
+ *   landmark being a component picked by pruned landmark labeling. Component c reaches
+ *   component d if a landmark reached by c reaches d, so a query is the intersection of two
+ *   short sorted lists, and the labels grow with the graph instead of its square.
+ */
+typedef struct
+{
+    int component_count; /* number of components */
+    long *out_offsets;   /* where the landmarks each component reaches start in out_labels */
+    int *out_labels;     /* the landmarks each component reaches, by rank */
+    long *in_offsets;    /* where the landmarks that reach each component start in in_labels */
+    int *in_labels;      /* the landmarks that reach each component, by rank */
+} LABELS;
+
+/** @brief Builds the labels with pruned landmark labeling.
+ *
+ *   The components are ranked by the product of their links in and out, so the ones most
+ *   paths go through come first. From each component in that order, a breadth-first search
+ *   forward adds it to the in-labels of the components it reaches, and one backward adds it
+ *   to the out-labels of the components that reach it. A search stops at the components
+ *   whose pair is already answered by the labels so far.
+ *
+ *   @param condensation the components, the transitive closure is not needed
+ *   @param graph        the links between the cities
+ *   @return the labels
+ */
+LABELS *build_labels(CONDENSATION *condensation, GRAPH *graph);
+
+/** @brief Checks whether one city reaches another with the labels.
+ *
+ *   A city never reaches itself, like in the transitive closure of the cities.
+ *
+ *   @param labels       the labels of the components
+ *   @param condensation the components
+ *   @param from         the starting city
+ *   @param to           the ending city
+ *   @return 1 if a path exists or 0 otherwise
+ */
+int labels_reach(LABELS *labels, CONDENSATION *condensation, int from, int to);
+
+/** @brief Frees up the labels from memory.
+ *
+ *   @param labels the labels
+ *   @return void
+ */
+void free_labels(LABELS *labels);
+
+#endif
@@ -0,0 +1,198 @@
+#include "pair_set.h"
+
+/** @brief Number of places the hash table starts with. */
+#define PAIR_SET_START 1024
+
+/** @brief Finds the place of a key in the hash table.
+ *
+ *   @param keys     the hash table
+ *   @param capacity the number of places, a power of 2
+ *   @param key      the key
+ *   @return the place that holds the key, or the empty place where it goes
+ */
+static long find_place(const long long *keys, long capacity, long long key)
+{
+    /* Multiplicative hashing, then the next places one by one. */
+    unsigned long long hash = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+    long place = (long)((hash >> 17) & (unsigned long long)(capacity - 1));
+
+    while (keys[place] != -1 && keys[place] != key)
+    {
+        place = (place + 1) & (capacity - 1);
+    }
+    return place;
+}
+
+/** @brief Doubles the number of places of the hash table.
+ *
+ *   @param pairs the set
+ *   @return void
+ */
+static void grow_pair_set(PAIR_SET *pairs)
+{
+    long capacity = pairs->capacity * 2;
+    long long *keys = (long long *)malloc(capacity * sizeof(long long));
+    int *values = NULL;
+
+    if (pairs->keep_values)
+    {
+        values = (int *)malloc(capacity * sizeof(int));
+    }
+    if (keys == NULL || (pairs->keep_values && values == NULL))
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(keys, 0xFF, capacity * sizeof(long long));
+
+    for (long i = 0; i < pairs->capacity; i++)
+    {
+        if (pairs->keys[i] != -1)
+        {
+            long place = find_place(keys, capacity, pairs->keys[i]);
+
+            keys[place] = pairs->keys[i];
+            if (values != NULL)
+            {
+                values[place] = pairs->values[i];
+            }
+        }
+    }
+    free(pairs->keys);
+    free(pairs->values);
+    pairs->keys = keys;
+    pairs->values = values;
+    pairs->capacity = capacity;
+}
+
+PAIR_SET *new_pair_set(int city_count, int keep_values)
+{
+    PAIR_SET *pairs = (PAIR_SET *)malloc(sizeof(PAIR_SET));
+
+    if (pairs == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    pairs->city_count = city_count;
+    pairs->keep_values = keep_values;
+    pairs->bitmap = NULL;
+    pairs->rows = NULL;
+    pairs->keys = NULL;
+    pairs->values = NULL;
+    pairs->capacity = 0;
+    pairs->size = 0;
+
+    if (city_count <= PAIR_BITMAP_LIMIT)
+    {
+        size_t bits = (size_t)city_count * city_count;
+
+        pairs->bitmap = (unsigned long long *)calloc(bits / 64 + 1, sizeof(unsigned long long));
+        if (keep_values)
+        {
+            pairs->rows = (int **)calloc((size_t)city_count + 1, sizeof(int *));
+        }
+        if (pairs->bitmap == NULL || (keep_values && pairs->rows == NULL))
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        pairs->capacity = PAIR_SET_START;
+        pairs->keys = (long long *)malloc(pairs->capacity * sizeof(long long));
+        if (keep_values)
+        {
+            pairs->values = (int *)malloc(pairs->capacity * sizeof(int));
+        }
+        if (pairs->keys == NULL || (keep_values && pairs->values == NULL))
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+        /* All bytes 0xFF make every key -1, which is the empty place. */
+        memset(pairs->keys, 0xFF, pairs->capacity * sizeof(long long));
+    }
+    return pairs;
+}
+
+void add_pair(PAIR_SET *pairs, int start, int end, int value)
+{
+    long long key = (long long)start * pairs->city_count + end;
+    long place;
+
+    if (pairs->bitmap != NULL)
+    {
+        if (pairs->keep_values && ((pairs->bitmap[key / 64] >> (key % 64)) & 1ULL) == 0)
+        {
+            /* The bitmap tells which values of a row are set, so rows are not cleared. */
+            if (pairs->rows[start] == NULL &&
+                (pairs->rows[start] = (int *)malloc(pairs->city_count * sizeof(int))) == NULL)
+            {
+                printf("Error: Could not allocate memory\n");
+                exit(EXIT_FAILURE);
+            }
+            pairs->rows[start][end] = value;
+        }
+        pairs->bitmap[key / 64] |= 1ULL << (key % 64);
+        return;
+    }
+
+    /* The hash table is kept at most half full, so the searches stay short. */
+    if (2 * (pairs->size + 1) > pairs->capacity)
+    {
+        grow_pair_set(pairs);
+    }
+    place = find_place(pairs->keys, pairs->capacity, key);
+    if (pairs->keys[place] == -1)
+    {
+        pairs->keys[place] = key;
+        if (pairs->keep_values)
+        {
+            pairs->values[place] = value;
+        }
+        pairs->size++;
+    }
+}
+
+int has_pair(PAIR_SET *pairs, int start, int end)
+{
+    long long key = (long long)start * pairs->city_count + end;
+
+    if (pairs->bitmap != NULL)
+    {
+        return (int)((pairs->bitmap[key / 64] >> (key % 64)) & 1ULL);
+    }
+    return pairs->keys[find_place(pairs->keys, pairs->capacity, key)] == key;
+}
+
+int find_pair(PAIR_SET *pairs, int start, int end)
+{
+    long long key = (long long)start * pairs->city_count + end;
+    long place;
+
+    if (pairs->bitmap != NULL)
+    {
+        return has_pair(pairs, start, end) ? pairs->rows[start][end] : -1;
+    }
+    place = find_place(pairs->keys, pairs->capacity, key);
+    return (pairs->keys[place] == key) ? pairs->values[place] : -1;
+}
+
+void free_pair_set(PAIR_SET *pairs)
+{
+    if (pairs->rows != NULL)
+    {
+        for (int i = 0; i < pairs->city_count; i++)
+        {
+            free(pairs->rows[i]);
+        }
+    }
+    free(pairs->rows);
+    free(pairs->bitmap);
+    free(pairs->keys);
+    free(pairs->values);
+    free(pairs);
+}
@@ -0,0 +1,79 @@
+#ifndef PAIR_SET_H
+#define PAIR_SET_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Largest number of cities for which a pair set is a bitmap of all the pairs.
+ *
+ *   A bitmap of 16384 x 16384 pairs takes 32 MB. Above that the pairs are kept in a hash
+ *   table, which grows with the number of pairs instead.
+ */
+#define PAIR_BITMAP_LIMIT 16384
+
+/** @brief Represents a set of (start, end) pairs of cities, with a value for each pair if
+ *   asked for.
+ *
+ *   Adding a pair, checking for a pair and finding its value all take constant time.
+ */
+typedef struct
+{
+    int city_count;             /* number of cities */
+    int keep_values;            /* whether the value of each pair is kept */
+    unsigned long long *bitmap; /* a bit for each pair, or NULL if the hash table is used */
+    int **rows;                 /* with the bitmap, the values of the pairs of each starting
+                                   city, allocated with its first pair */
+    long long *keys;            /* the hash table, start * city_count + end or -1 if empty */
+    int *values;                /* with the hash table, the value of the pair of each place */
+    long capacity;              /* number of places in the hash table, a power of 2 */
+    long size;                  /* number of pairs in the set */
+} PAIR_SET;
+
+/** @brief Creates an empty set of pairs.
+ *
+ *   Keeping the values costs an int for each city of every starting city that has a pair,
+ *   or for each place of the hash table.
+ *
+ *   @param city_count  the number of cities
+ *   @param keep_values 1 to keep the value of each pair or 0 otherwise
+ *   @return the new set
+ */
+PAIR_SET *new_pair_set(int city_count, int keep_values);
+
+/** @brief Adds a pair to the set. A pair already in the set keeps its value.
+ *
+ *   @param pairs the set
+ *   @param start the starting city
+ *   @param end   the ending city
+ *   @param value the value of the pair, 0 or more, ignored if the set keeps no values
+ *   @return void
+ */
+void add_pair(PAIR_SET *pairs, int start, int end, int value);
+
+/** @brief Finds the value of a pair.
+ *
+ *   @param pairs the set, which keeps values
+ *   @param start the starting city
+ *   @param end   the ending city
+ *   @return the value of the pair, or -1 if the pair is not in the set
+ */
+int find_pair(PAIR_SET *pairs, int start, int end);
+
+/** @brief Checks whether a pair is in the set.
+ *
+ *   @param pairs the set
+ *   @param start the starting city
+ *   @param end   the ending city
+ *   @return 1 if the pair is in the set or 0 otherwise
+ */
+int has_pair(PAIR_SET *pairs, int start, int end);
+
+/** @brief Frees up the set from memory.
+ *
+ *   @param pairs the set
+ *   @return void
+ */
+void free_pair_set(PAIR_SET *pairs);
+
+#endif
@@ -0,0 +1,189 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+#include "parallel_closure.h"
+
+/** @brief Takes the next starting cities of a range.
+ *
+ *   @param range the range
+ *   @param first the first city taken
+ *   @param end   the city after the last one taken
+ *   @return 1 if cities were taken or 0 if the range is empty
+ */
+static int take_sources(SOURCE_RANGE *range, int *first, int *end)
+{
+    int taken = 0;
+
+    pthread_mutex_lock(&range->lock);
+    if (range->next < range->end)
+    {
+        *first = range->next;
+        *end = (range->end - range->next > SOURCE_CHUNK) ? range->next + SOURCE_CHUNK
+                                                         : range->end;
+        range->next = *end;
+        taken = 1;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return taken;
+}
+
+/** @brief Moves the back half of the largest other range to the range of a thread.
+ *
+ *   @param worker the thread without cities left
+ *   @return 1 if cities were stolen or 0 if all the ranges are empty
+ */
+static int steal_sources(CLOSURE_WORKER *worker)
+{
+    while (1)
+    {
+        int victim = -1, largest = 0;
+        int first = 0, end = 0;
+
+        /* The sizes are only a hint, they are checked again under the lock. */
+        for (int i = 0; i < worker->thread_count; i++)
+        {
+            SOURCE_RANGE *range = &worker->ranges[i];
+            int left = 0;
+
+            pthread_mutex_lock(&range->lock);
+            left = range->end - range->next;
+            pthread_mutex_unlock(&range->lock);
+            if (i != worker->id && left > largest)
+            {
+                victim = i;
+                largest = left;
+            }
+        }
+        if (victim == -1)
+        {
+            return 0;
+        }
+
+        pthread_mutex_lock(&worker->ranges[victim].lock);
+        if (worker->ranges[victim].end > worker->ranges[victim].next)
+        {
+            end = worker->ranges[victim].end;
+            first = end - (end - worker->ranges[victim].next + 1) / 2;
+            worker->ranges[victim].end = first;
+        }
+        pthread_mutex_unlock(&worker->ranges[victim].lock);
+
+        if (first < end)
+        {
+            pthread_mutex_lock(&worker->ranges[worker->id].lock);
+            worker->ranges[worker->id].next = first;
+            worker->ranges[worker->id].end = end;
+            pthread_mutex_unlock(&worker->ranges[worker->id].lock);
+            return 1;
+        }
+    }
+}
+
+BIT_MATRIX *bfs_closure(GRAPH *graph, int thread_count)
+{
+    int N = graph->city_count;
+    BIT_MATRIX *closure = new_bit_matrix(N);
+    SOURCE_RANGE *ranges = NULL;
+    CLOSURE_WORKER *workers = NULL;
+    pthread_t *threads = NULL;
+
+    if (thread_count <= 0)
+    {
+        thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (thread_count < 1)
+    {
+        thread_count = 1;
+    }
+
+    ranges = (SOURCE_RANGE *)malloc(thread_count * sizeof(SOURCE_RANGE));
+    workers = (CLOSURE_WORKER *)malloc(thread_count * sizeof(CLOSURE_WORKER));
+    threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    if (ranges == NULL || workers == NULL || threads == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Each thread starts with an equal range of the cities. */
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_mutex_init(&ranges[i].lock, NULL);
+        ranges[i].next = (int)((long)N * i / thread_count);
+        ranges[i].end = (int)((long)N * (i + 1) / thread_count);
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i].graph = graph;
+        workers[i].closure = closure;
+        workers[i].ranges = ranges;
+        workers[i].thread_count = thread_count;
+        workers[i].id = i;
+        if (pthread_create(&threads[i], NULL, closure_worker, &workers[i]) != 0)
+        {
+            printf("Error: Could not create worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+        pthread_mutex_destroy(&ranges[i].lock);
+    }
+
+    free(ranges);
+    free(workers);
+    free(threads);
+    return closure;
+}
+
+void *closure_worker(void *worker)
+{
+    CLOSURE_WORKER *w = (CLOSURE_WORKER *)worker;
+    int *queue = (int *)malloc(((size_t)w->graph->city_count + 1) * sizeof(int));
+    int first = 0, end = 0;
+
+    if (queue == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    while (take_sources(&w->ranges[w->id], &first, &end) == 1 || steal_sources(w) == 1)
+    {
+        /* After a steal the range has cities again, and they are taken on the next turn. */
+        for (int source = first; source < end; source++)
+        {
+            search_from(w->graph, w->closure, source, queue);
+        }
+        first = end = 0;
+    }
+
+    free(queue);
+    return NULL;
+}
+
+void search_from(GRAPH *graph, BIT_MATRIX *closure, int source, int *queue)
+{
+    unsigned long long *row = get_row(closure, source);
+    int head = 0, tail = 0;
+
+    /* The source is only marked if a path leads back to it, so it starts from its links. */
+    queue[tail++] = source;
+    while (head < tail)
+    {
+        int city = queue[head++];
+
+        for (long link = graph->offsets[city]; link < graph->offsets[city + 1]; link++)
+        {
+            int next = graph->targets[link];
+            unsigned long long mask = 1ULL << (next % WORD_BITS);
+
+            if ((row[next / WORD_BITS] & mask) == 0)
+            {
+                row[next / WORD_BITS] |= mask;
+                queue[tail++] = next;
+            }
+        }
+    }
+}
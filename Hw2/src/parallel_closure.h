@@ -0,0 +1,65 @@
+#ifndef PARALLEL_CLOSURE_H
+#define PARALLEL_CLOSURE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bit_matrix.h"
+#include "graph.h"
+
+/** @brief Number of starting cities a thread takes from its range at a time. */
+#define SOURCE_CHUNK 16
+
+/** @brief The starting cities a thread has left to search from.
+ *
+ *  The thread takes cities from the front. A thread without cities left steals the back
+ *  half of the largest range of another thread.
+ */
+typedef struct
+{
+    pthread_mutex_t lock; /* protects next */
+    int next;             /* the next city to search from */
+    int end;              /* the city after the last one of the range */
+} SOURCE_RANGE;
+
+/** @brief What each thread of bfs_closure() needs. */
+typedef struct
+{
+    GRAPH *graph;         /* the links between the cities */
+    BIT_MATRIX *closure;  /* the transitive closure, one row written by each search */
+    SOURCE_RANGE *ranges; /* the range of each thread */
+    int thread_count;     /* number of threads, and of ranges */
+    int id;               /* the range of this thread */
+} CLOSURE_WORKER;
+
+/** @brief Builds the transitive closure with a breadth-first search from each city.
+ *
+ *   The searches are independent, so they run on many threads. Each search writes only
+ *   the row of its starting city, which is also the visited bitmap of the search, so the
+ *   threads need no lock to write the closure. The starting cities are split in one range
+ *   for each thread, and a thread that runs out of cities steals from the others.
+ *
+ *   @param graph        the links between the cities
+ *   @param thread_count the number of threads, or 0 to use one per processor
+ *   @return the transitive closure bit matrix
+ */
+BIT_MATRIX *bfs_closure(GRAPH *graph, int thread_count);
+
+/** @brief Thread that searches from the cities of its range, and from stolen ones.
+ *
+ *   @param worker the CLOSURE_WORKER of the thread
+ *   @return NULL
+ */
+void *closure_worker(void *worker);
+
+/** @brief Writes the row of the cities a city reaches through at least one link.
+ *
+ *   @param graph   the links between the cities
+ *   @param closure the transitive closure
+ *   @param source  the city to search from
+ *   @param queue   the cities reached in order, room for all the cities
+ *   @return void
+ */
+void search_from(GRAPH *graph, BIT_MATRIX *closure, int source, int *queue);
+
+#endif
@@ -0,0 +1,387 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+#include "query.h"
+
+/** @brief Makes room for more characters in an output buffer.
+ *
+ *   @param output the buffer
+ *   @param more   the number of characters to make room for
+ *   @return void
+ */
+static void reserve_output(OUTPUT_BUFFER *output, size_t more)
+{
+    if (output->size + more <= output->capacity)
+    {
+        return;
+    }
+    while (output->size + more > output->capacity)
+    {
+        output->capacity = (output->capacity == 0) ? 65536 : output->capacity * 2;
+    }
+    output->data = (char *)realloc(output->data, output->capacity);
+    if (output->data == NULL)
+    {
+        printf("Error: Unable to Allocate Memory using realloc\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/** @brief Writes a number at the end of an output buffer.
+ *
+ *   @param output the buffer, with room for the number
+ *   @param number the number, 0 or more
+ *   @return void
+ */
+static void append_number(OUTPUT_BUFFER *output, int number)
+{
+    char digits[12];
+    int count = 0;
+
+    /* The digits come out last first. */
+    do
+    {
+        digits[count++] = (char)('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+
+    while (count > 0)
+    {
+        output->data[output->size++] = digits[--count];
+    }
+}
+
+/** @brief Writes a string at the end of an output buffer.
+ *
+ *   @param output the buffer, with room for the string
+ *   @param text   the string
+ *   @return void
+ */
+static void append_text(OUTPUT_BUFFER *output, const char *text)
+{
+    size_t length = strlen(text);
+
+    memcpy(output->data + output->size, text, length);
+    output->size += length;
+}
+
+/** @brief Answers a part of a batch of queries.
+ *
+ *   @param w          the worker, with the queries and the output
+ *   @param city_count the number of cities
+ *   @param first      the first query of the part
+ *   @param end        the query after the last one of the part
+ *   @return void
+ */
+static void answer_part(QUERY_WORKER *w, int city_count, int first, int end)
+{
+    for (int q = first; q < end; q++)
+    {
+        int start_city = w->starts[q], end_city = w->ends[q];
+        int length = 0;
+
+        /* Only the paths the closure or the labels of the components say exist are searched. */
+        if (start_city >= 0 && start_city < city_count && end_city >= 0 &&
+            end_city < city_count &&
+            (w->condensation->reach != NULL
+                 ? reaches(w->condensation, start_city, end_city)
+                 : labels_reach(w->labels, w->condensation, start_city, end_city)))
+        {
+            length = find_path(w->search, start_city, end_city, w->path);
+        }
+
+        if (length == 0)
+        {
+            reserve_output(&w->output, 3);
+            append_text(&w->output, "no\n");
+            continue;
+        }
+
+        /* "yes", then each city with at most 10 digits and " => ". */
+        reserve_output(&w->output, 5 + (size_t)length * 14);
+        append_text(&w->output, "yes ");
+        for (int i = 0; i < length; i++)
+        {
+            append_number(&w->output, w->path[i]);
+            append_text(&w->output, (i < length - 1) ? " => " : "\n");
+        }
+    }
+}
+
+void answer_queries(GRAPH *graph, GRAPH *reverse, CONDENSATION *condensation, LABELS *labels,
+                    char *query_filename, int thread_count)
+{
+    int own_reverse = (reverse == NULL), own_condensation = (condensation == NULL);
+    int own_labels = 0;
+    QUERY_BATCH_STATE state;
+    QUERY_WORKER *workers = NULL;
+    pthread_t *threads = NULL;
+    int *starts = (int *)malloc(QUERY_BATCH * sizeof(int));
+    int *ends = (int *)malloc(QUERY_BATCH * sizeof(int));
+    char line[256];
+    long line_number = 0;
+    int done = 0;
+    FILE *fp = NULL;
+
+    if (strcmp(query_filename, "-") == 0)
+    {
+        fp = stdin;
+    }
+    else if ((fp = fopen(query_filename, "r")) == NULL)
+    {
+        printf("Query file cannot be read!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (own_reverse)
+    {
+        reverse = reverse_graph(graph);
+    }
+
+    /* Too many components for their closure get labels instead. */
+    if (own_condensation)
+    {
+        condensation = condense_graph(graph);
+        if (condensation->component_count <= MAX_CLOSURE_COMPONENTS)
+        {
+            build_condensed_closure(condensation, graph);
+        }
+    }
+    if (condensation->reach == NULL && labels == NULL)
+    {
+        labels = build_labels(condensation, graph);
+        own_labels = 1;
+    }
+
+    if (thread_count <= 0)
+    {
+        thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (thread_count < 1)
+    {
+        thread_count = 1;
+    }
+
+    workers = (QUERY_WORKER *)malloc(thread_count * sizeof(QUERY_WORKER));
+    threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    if (starts == NULL || ends == NULL || workers == NULL || threads == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_mutex_init(&state.lock, NULL);
+    pthread_cond_init(&state.changed, NULL);
+    state.batch = 0;
+    state.count = 0;
+    state.thread_count = thread_count;
+    state.busy = 0;
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i].state = &state;
+        workers[i].id = i;
+        workers[i].condensation = condensation;
+        workers[i].labels = labels;
+        workers[i].search = new_search(graph, reverse);
+        workers[i].path = (int *)malloc(((size_t)graph->city_count + 1) * sizeof(int));
+        workers[i].starts = starts;
+        workers[i].ends = ends;
+        workers[i].output.data = NULL;
+        workers[i].output.size = 0;
+        workers[i].output.capacity = 0;
+        if (workers[i].path == NULL)
+        {
+            printf("Error: Could not allocate memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    /* The threads are started once and wait for each batch. */
+    for (int i = 0; i < thread_count; i++)
+    {
+        if (pthread_create(&threads[i], NULL, query_worker, &workers[i]) != 0)
+        {
+            printf("Error: Could not create worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    while (done == 0)
+    {
+        int count = 0, result = 0;
+
+        /* Reads the next batch of queries, skipping empty lines. */
+        while (count < QUERY_BATCH && (result = read_query_line(line, sizeof(line), fp)) != 0)
+        {
+            line_number++;
+            if (result < 0)
+            {
+                printf("Query on line %ld is too long\n", line_number);
+                printf("Query format: number1,number2\n");
+                exit(EXIT_FAILURE);
+            }
+            if (strspn(line, " \t\r\n") == strlen(line))
+            {
+                continue;
+            }
+            if (parse_query(line, &starts[count], &ends[count]) == 0)
+            {
+                printf("Invalid query on line %ld\n", line_number);
+                printf("Query format: number1,number2\n");
+                exit(EXIT_FAILURE);
+            }
+            count++;
+        }
+        done = (count < QUERY_BATCH);
+
+        /* Hands the batch to the threads and waits until they have all answered their part. */
+        pthread_mutex_lock(&state.lock);
+        state.count = count;
+        state.busy = thread_count;
+        state.batch++;
+        pthread_cond_broadcast(&state.changed);
+        while (state.busy > 0)
+        {
+            pthread_cond_wait(&state.changed, &state.lock);
+        }
+        pthread_mutex_unlock(&state.lock);
+
+        /* The answers are printed in the order of the queries. */
+        for (int i = 0; i < thread_count; i++)
+        {
+            fwrite(workers[i].output.data, 1, workers[i].output.size, stdout);
+            workers[i].output.size = 0;
+        }
+    }
+    fflush(stdout);
+
+    /* A batch without queries tells the threads to stop. */
+    pthread_mutex_lock(&state.lock);
+    state.count = -1;
+    state.batch++;
+    pthread_cond_broadcast(&state.changed);
+    pthread_mutex_unlock(&state.lock);
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&state.lock);
+    pthread_cond_destroy(&state.changed);
+
+    if (fp != stdin)
+    {
+        fclose(fp);
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        free_search(workers[i].search);
+        free(workers[i].path);
+        free(workers[i].output.data);
+    }
+    if (own_labels)
+    {
+        free_labels(labels);
+    }
+    if (own_condensation)
+    {
+        free_condensation(condensation);
+    }
+    if (own_reverse)
+    {
+        free_graph(reverse);
+    }
+    free(workers);
+    free(threads);
+    free(starts);
+    free(ends);
+}
+
+void *query_worker(void *worker)
+{
+    QUERY_WORKER *w = (QUERY_WORKER *)worker;
+    QUERY_BATCH_STATE *state = w->state;
+    int city_count = w->search->graph->city_count;
+    long batch = 0;
+
+    for (;;)
+    {
+        int first = 0, end = 0;
+
+        pthread_mutex_lock(&state->lock);
+        while (state->batch == batch)
+        {
+            pthread_cond_wait(&state->changed, &state->lock);
+        }
+        batch = state->batch;
+        if (state->count < 0)
+        {
+            pthread_mutex_unlock(&state->lock);
+            return NULL;
+        }
+        /* The batch is split in equal parts, one for each thread. */
+        first = (int)((long)state->count * w->id / state->thread_count);
+        end = (int)((long)state->count * (w->id + 1) / state->thread_count);
+        pthread_mutex_unlock(&state->lock);
+
+        answer_part(w, city_count, first, end);
+
+        pthread_mutex_lock(&state->lock);
+        state->busy--;
+        if (state->busy == 0)
+        {
+            pthread_cond_broadcast(&state->changed);
+        }
+        pthread_mutex_unlock(&state->lock);
+    }
+}
+
+int read_query_line(char *line, int size, FILE *fp)
+{
+    size_t length = 0;
+    int c = 0;
+
+    if (fgets(line, size, fp) == NULL)
+    {
+        return 0;
+    }
+    length = strlen(line);
+    /* A full line without its end only fits if the file ends right after it. */
+    if (length == (size_t)size - 1 && line[length - 1] != '\n')
+    {
+        c = fgetc(fp);
+        if (c != EOF && c != '\n')
+        {
+            return -1;
+        }
+    }
+    return 1;
+}
+
+int parse_query(char *line, int *start_city, int *end_city)
+{
+    char *end = NULL;
+    long start_value = 0, end_value = 0;
+
+    start_value = strtol(line, &end, 10);
+    if (end == line)
+    {
+        return 0;
+    }
+    line = end;
+    line += strspn(line, " \t");
+    if (*line == ',')
+    {
+        line++;
+    }
+
+    end_value = strtol(line, &end, 10);
+    if (end == line || strspn(end, " \t\r\n") != strlen(end))
+    {
+        return 0;
+    }
+
+    /* Cities out of range only need to stay out of range. */
+    *start_city = (start_value < -1 || start_value > 2147483647L) ? -1 : (int)start_value;
+    *end_city = (end_value < -1 || end_value > 2147483647L) ? -1 : (int)end_value;
+    return 1;
+}
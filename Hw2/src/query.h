@@ -0,0 +1,99 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "graph.h"
+#include "search.h"
+#include "scc.h"
+#include "labels.h"
+
+/** @brief Number of queries read and answered at a time. */
+#define QUERY_BATCH 65536
+
+/** @brief A buffer the answers are written to before they go to the output. */
+typedef struct
+{
+    char *data;      /* the characters written */
+    size_t size;     /* the number of characters written */
+    size_t capacity; /* the number of characters data has room for */
+} OUTPUT_BUFFER;
+
+/** @brief What the threads of answer_queries() share to wait for each batch. */
+typedef struct
+{
+    pthread_mutex_t lock;   /* guards the other fields */
+    pthread_cond_t changed; /* signaled when a batch starts or a thread finishes one */
+    long batch;             /* the number of batches started */
+    int count;              /* the number of queries of the batch, -1 when none are left */
+    int thread_count;       /* the number of threads */
+    int busy;               /* the number of threads still answering the batch */
+} QUERY_BATCH_STATE;
+
+/** @brief What each thread of answer_queries() needs. */
+typedef struct
+{
+    QUERY_BATCH_STATE *state;   /* the batch shared by the threads */
+    int id;                     /* the part of each batch of this thread, from 0 */
+    CONDENSATION *condensation; /* the components, with their closure if it was built */
+    LABELS *labels;             /* the labels of the components, if there is no closure */
+    SEARCH *search;             /* the memory of the searches of this thread */
+    int *path;                  /* room for the path of a query */
+    int *starts;                /* the starting city of each query of the batch */
+    int *ends;                  /* the ending city of each query of the batch */
+    OUTPUT_BUFFER output;       /* the answers of this thread */
+} QUERY_WORKER;
+
+/** @brief Answers a file of queries, one "source,destination" pair on each line.
+ *
+ *   The graph is indexed once, unless an index is given: if the graph has at most
+ *   MAX_CLOSURE_COMPONENTS strongly connected components, the closure of the components
+ *   answers whether each path exists, otherwise their 2-hop labels do, and only existing
+ *   paths are searched for with a bidirectional search. The queries are read QUERY_BATCH at
+ *   a time and split between the threads, which are started once and wait for each batch.
+ *   The answers are printed in the order of the queries, "yes" followed by the shortest path
+ *   or "no", one on each line. A line too long for a query ends the program.
+ *
+ *   @param graph          the links between the cities
+ *   @param reverse        the links reversed, or NULL to build them here
+ *   @param condensation   the components with their transitive closure, or NULL to build
+ *                         them here
+ *   @param labels         the labels of the components when they have no transitive
+ *                         closure, or NULL to build them here
+ *   @param query_filename the file with the queries, or "-" to read them from the console
+ *   @param thread_count   the number of threads, or 0 to use one per processor
+ *   @return void
+ */
+void answer_queries(GRAPH *graph, GRAPH *reverse, CONDENSATION *condensation, LABELS *labels,
+                    char *query_filename, int thread_count);
+
+/** @brief Thread that answers its part of each batch of queries, until there are none left.
+ *
+ *   @param worker the QUERY_WORKER of the thread
+ *   @return NULL
+ */
+void *query_worker(void *worker);
+
+/** @brief Reads a line of a file of queries.
+ *
+ *   @param line the room for the line
+ *   @param size the size of line
+ *   @param fp   the file
+ *   @return 1 if a line was read, 0 at the end of the file, or -1 if the line does not fit
+ */
+int read_query_line(char *line, int size, FILE *fp);
+
+/** @brief Reads the cities of a query.
+ *
+ *   The cities are separated by a comma or by spaces.
+ *
+ *   @param line       the line of the query
+ *   @param start_city the starting city
+ *   @param end_city   the ending city
+ *   @return 1 if the line is a query or 0 otherwise
+ */
+int parse_query(char *line, int *start_city, int *end_city);
+
+#endif
@@ -0,0 +1,146 @@
+#include <limits.h>
+#include <math.h>
+#include "route.h"
+
+double *read_coordinates(char *filename, int city_count)
+{
+    double *coordinates = (double *)malloc(((size_t)city_count + 1) * 2 * sizeof(double));
+    FILE *fp = NULL;
+
+    if (coordinates == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    if ((fp = fopen(filename, "r")) == NULL)
+    {
+        printf("Heuristic file cannot be read!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < city_count; i++)
+    {
+        if (fscanf(fp, "%lf %lf", &coordinates[2 * i], &coordinates[2 * i + 1]) != 2)
+        {
+            printf("Heuristic file has invalid coordinates for city %d!\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    fclose(fp);
+    return coordinates;
+}
+
+/** @brief Gets the straight-line distance between two cities, rounded down.
+ *
+ *   Rounding down keeps it no longer than any route, whose distance is a whole number.
+ *
+ *   @param coordinates the coordinates of the cities, or NULL
+ *   @param from        the first city
+ *   @param to          the second city
+ *   @return the distance, or 0 without coordinates
+ */
+static long long estimate_distance(double *coordinates, int from, int to)
+{
+    if (coordinates == NULL)
+    {
+        return 0;
+    }
+    return (long long)floor(hypot(coordinates[2 * from] - coordinates[2 * to],
+                                  coordinates[2 * from + 1] - coordinates[2 * to + 1]));
+}
+
+long long find_route(GRAPH *graph, double *coordinates, int start_city, int end_city, int *path,
+                     int *length)
+{
+    int N = graph->city_count;
+    long long *distance = NULL; /* the shortest distance found to each city */
+    int *parent = NULL;         /* the city before each city on its shortest route */
+    char *in_heap = NULL;       /* whether each city is waiting in the heap */
+    PAIRING_HEAP *heap = NULL;
+    long long total = -1;
+
+    *length = 0;
+    if (start_city < 0 || start_city >= N || end_city < 0 || end_city >= N ||
+        start_city == end_city)
+    {
+        return -1;
+    }
+
+    distance = (long long *)malloc(((size_t)N + 1) * sizeof(long long));
+    parent = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    in_heap = (char *)calloc((size_t)N + 1, sizeof(char));
+    if (distance == NULL || parent == NULL || in_heap == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < N; i++)
+    {
+        distance[i] = LLONG_MAX;
+    }
+    heap = new_pairing_heap(N);
+
+    distance[start_city] = 0;
+    parent[start_city] = -1;
+    push_heap(heap, start_city, estimate_distance(coordinates, start_city, end_city));
+    in_heap[start_city] = 1;
+
+    while (heap->root != -1)
+    {
+        int city = pop_heap(heap);
+
+        in_heap[city] = 0;
+        if (city == end_city)
+        {
+            break;
+        }
+
+        for (long link = graph->offsets[city]; link < graph->offsets[city + 1]; link++)
+        {
+            int next = graph->targets[link];
+            long long next_distance = distance[city] +
+                                      ((graph->weights == NULL) ? 1 : graph->weights[link]);
+            long long key = 0;
+
+            if (next_distance >= distance[next])
+            {
+                continue;
+            }
+
+            /* A city already visited comes back, in case the estimates were not consistent. */
+            distance[next] = next_distance;
+            parent[next] = city;
+            key = next_distance + estimate_distance(coordinates, next, end_city);
+            if (in_heap[next])
+            {
+                decrease_key(heap, next, key);
+            }
+            else
+            {
+                push_heap(heap, next, key);
+                in_heap[next] = 1;
+            }
+        }
+    }
+
+    if (distance[end_city] != LLONG_MAX)
+    {
+        total = distance[end_city];
+
+        /* Counts the cities, then writes them from the last one back. */
+        for (int city = end_city; city != -1; city = parent[city])
+        {
+            (*length)++;
+        }
+        for (int city = end_city, k = *length - 1; city != -1; city = parent[city], k--)
+        {
+            path[k] = city;
+        }
+    }
+
+    free_pairing_heap(heap);
+    free(distance);
+    free(parent);
+    free(in_heap);
+    return total;
+}
@@ -0,0 +1,42 @@
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "graph.h"
+#include "heap.h"
+
+/** @brief Reads the coordinates of the cities, the heuristic of find_route().
+ *
+ *   The file has a line "x y" for each city, in order. The straight-line distance between
+ *   two cities must be no longer than the distance of any route between them, so the links
+ *   must be at least as long as the straight line between their cities. The program is
+ *   terminated if the file cannot be read or has invalid values.
+ *
+ *   @param filename   the name of the file
+ *   @param city_count the number of cities
+ *   @return the coordinates, x and y of city i at 2 * i and 2 * i + 1
+ */
+double *read_coordinates(char *filename, int city_count);
+
+/** @brief Finds the route with the smallest total distance between two cities.
+ *
+ *   Dijkstra's algorithm, with the cities waiting to be visited in a pairing heap, stops as
+ *   soon as the ending city is taken out of the heap. With coordinates, the cities are taken
+ *   out by their distance plus their straight-line distance to the ending city instead,
+ *   which is A*: the search heads for the ending city and visits fewer cities. Links without
+ *   distances have distance 1. A city never has a route to itself.
+ *
+ *   @param graph       the links between the cities, with their distances
+ *   @param coordinates the coordinates of the cities, or NULL for Dijkstra's algorithm
+ *   @param start_city  the starting city
+ *   @param end_city    the ending city
+ *   @param path        the cities of the route, room for all the cities of the graph
+ *   @param length      the number of cities of the route, 0 if no route exists
+ *   @return the total distance of the route, or -1 if no route exists
+ */
+long long find_route(GRAPH *graph, double *coordinates, int start_city, int end_city, int *path,
+                     int *length);
+
+#endif
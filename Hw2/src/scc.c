@@ -0,0 +1,198 @@
+#include "scc.h"
+
+CONDENSATION *condense_graph(GRAPH *graph)
+{
+    int N = graph->city_count;
+    CONDENSATION *condensation = (CONDENSATION *)malloc(sizeof(CONDENSATION));
+    int *index = (int *)malloc(((size_t)N + 1) * sizeof(int));  /* order each city is found */
+    int *low = (int *)malloc(((size_t)N + 1) * sizeof(int));    /* smallest index it reaches */
+    int *stack = (int *)malloc(((size_t)N + 1) * sizeof(int));  /* cities without component */
+    int *calls = (int *)malloc(((size_t)N + 1) * sizeof(int));  /* cities being searched */
+    long *next_link = (long *)malloc(((size_t)N + 1) * sizeof(long));
+    int found = 0, stack_size = 0;
+
+    if (condensation == NULL || index == NULL || low == NULL || stack == NULL ||
+        calls == NULL || next_link == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    condensation->city_count = N;
+    condensation->component_count = 0;
+    condensation->component = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    condensation->first_member = (long *)calloc((size_t)N + 2, sizeof(long));
+    condensation->members = (int *)malloc(((size_t)N + 1) * sizeof(int));
+    condensation->reach = NULL;
+
+    if (condensation->component == NULL || condensation->first_member == NULL ||
+        condensation->members == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < N; i++)
+    {
+        index[i] = -1;
+        condensation->component[i] = -1;
+    }
+
+    /* Depth-first search with an explicit stack, so long paths do not overflow the call stack. */
+    for (int root = 0; root < N; root++)
+    {
+        int depth = 0;
+
+        if (index[root] != -1)
+        {
+            continue;
+        }
+
+        calls[depth++] = root;
+        index[root] = low[root] = found++;
+        next_link[root] = graph->offsets[root];
+        stack[stack_size++] = root;
+
+        while (depth > 0)
+        {
+            int city = calls[depth - 1];
+
+            if (next_link[city] < graph->offsets[city + 1])
+            {
+                int next = graph->targets[next_link[city]++];
+
+                if (index[next] == -1)
+                {
+                    calls[depth++] = next;
+                    index[next] = low[next] = found++;
+                    next_link[next] = graph->offsets[next];
+                    stack[stack_size++] = next;
+                }
+                /* A city on the stack has no component yet, so it is in the current search. */
+                else if (condensation->component[next] == -1 && index[next] < low[city])
+                {
+                    low[city] = index[next];
+                }
+                continue;
+            }
+
+            /* All the links of city are done. */
+            depth--;
+            if (depth > 0 && low[city] < low[calls[depth - 1]])
+            {
+                low[calls[depth - 1]] = low[city];
+            }
+
+            /* The city is the first one found of its component, which is on top of the stack. */
+            if (low[city] == index[city])
+            {
+                int member;
+
+                do
+                {
+                    member = stack[--stack_size];
+                    condensation->component[member] = condensation->component_count;
+                    condensation->first_member[condensation->component_count + 1]++;
+                } while (member != city);
+                condensation->component_count++;
+            }
+        }
+    }
+
+    /* Lists the cities of each component, in increasing order. */
+    for (int c = 0; c < condensation->component_count; c++)
+    {
+        condensation->first_member[c + 1] += condensation->first_member[c];
+    }
+    memcpy(next_link, condensation->first_member,
+           ((size_t)condensation->component_count + 1) * sizeof(long));
+    for (int i = 0; i < N; i++)
+    {
+        condensation->members[next_link[condensation->component[i]]++] = i;
+    }
+
+    free(index);
+    free(low);
+    free(stack);
+    free(calls);
+    free(next_link);
+    return condensation;
+}
+
+void build_condensed_closure(CONDENSATION *condensation, GRAPH *graph)
+{
+    BIT_MATRIX *reach = new_bit_matrix(condensation->component_count);
+
+    for (int c = 0; c < condensation->component_count; c++)
+    {
+        unsigned long long *row_c = get_row(reach, c);
+
+        if (condensation->first_member[c + 1] - condensation->first_member[c] > 1)
+        {
+            set_bit(reach, c, c);
+        }
+
+        for (long m = condensation->first_member[c]; m < condensation->first_member[c + 1]; m++)
+        {
+            int city = condensation->members[m];
+
+            for (long link = graph->offsets[city]; link < graph->offsets[city + 1]; link++)
+            {
+                int d = condensation->component[graph->targets[link]];
+
+                /*
+                 * A component already reached brings nothing new: whatever reached it first
+                 * also reaches everything it reaches.
+                 */
+                if (d == c || get_bit(reach, c, d) == 1)
+                {
+                    continue;
+                }
+                set_bit(reach, c, d);
+                or_row(row_c, get_row(reach, d), reach->words);
+            }
+        }
+    }
+    condensation->reach = reach;
+}
+
+void get_reached_cities(CONDENSATION *condensation, int city, unsigned long long *row)
+{
+    BIT_MATRIX *reach = condensation->reach;
+    unsigned long long *components = get_row(reach, condensation->component[city]);
+
+    memset(row, 0, (((size_t)condensation->city_count + WORD_BITS - 1) / WORD_BITS) *
+                       sizeof(unsigned long long));
+
+    /* Every city of every component reached. */
+    for (int w = 0; w < reach->words; w++)
+    {
+        unsigned long long word = components[w];
+
+        while (word != 0)
+        {
+            int d = w * WORD_BITS + __builtin_ctzll(word);
+
+            word &= word - 1;
+            for (long m = condensation->first_member[d]; m < condensation->first_member[d + 1];
+                 m++)
+            {
+                int member = condensation->members[m];
+
+                row[member / WORD_BITS] |= 1ULL << (member % WORD_BITS);
+            }
+        }
+    }
+}
+
+void free_condensation(CONDENSATION *condensation)
+{
+    if (condensation->reach != NULL)
+    {
+        free_bit_matrix(condensation->reach);
+    }
+    free(condensation->component);
+    free(condensation->first_member);
+    free(condensation->members);
+    free(condensation);
+}
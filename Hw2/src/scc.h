@@ -0,0 +1,83 @@
+#ifndef SCC_H
+#define SCC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bit_matrix.h"
+#include "graph.h"
+
+/** @brief Largest number of components whose transitive closure is built to answer path
+ *   queries, 32768 x 32768 bits or 128 MB.
+ */
+#define MAX_CLOSURE_COMPONENTS 32768
+
+/** @brief Represents the graph of the strongly connected components of a graph.
+ *
+ *   All the cities of a component reach each other, so they reach the same cities. The
+ *   transitive closure is kept once for each component instead of once for each city.
+ */
+typedef struct
+{
+    int city_count;      /* number of cities */
+    int component_count; /* number of components */
+    int *component;      /* the component of each city */
+    long *first_member;  /* where the cities of each component start in members */
+    int *members;        /* the cities of each component, in increasing order */
+    BIT_MATRIX *reach;   /* bit d of row c is set if component c reaches component d */
+} CONDENSATION;
+
+/** @brief Finds the strongly connected components of a graph with Tarjan's algorithm.
+ *
+ *   The components are numbered in the order Tarjan's algorithm finishes them, so every
+ *   component only links to components with a smaller number.
+ *
+ *   @param graph the links between the cities
+ *   @return the components, with the reach matrix not built yet
+ */
+CONDENSATION *condense_graph(GRAPH *graph);
+
+/** @brief Builds the transitive closure of the components.
+ *
+ *   The components are visited in increasing order, so each one is done after all the
+ *   components it links to, and it reaches a component and everything that component
+ *   reaches: reach[c] |= reach[d]. A component reaches itself if it has more than one city.
+ *
+ *   @param condensation the components
+ *   @param graph        the links between the cities
+ *   @return void
+ */
+void build_condensed_closure(CONDENSATION *condensation, GRAPH *graph);
+
+/** @brief Gets the cities a city reaches.
+ *
+ *   @param condensation the components, with their transitive closure built
+ *   @param city         the city
+ *   @param row          the bits of the cities reached, room for a row of city_count bits
+ *   @return void
+ */
+void get_reached_cities(CONDENSATION *condensation, int city, unsigned long long *row);
+
+/** @brief Checks whether one city reaches another.
+ *
+ *   A city never reaches itself, like in the transitive closure of the cities.
+ *
+ *   @param condensation the components, with their transitive closure built
+ *   @param from         the starting city
+ *   @param to           the ending city
+ *   @return 1 if a path exists or 0 otherwise
+ */
+static inline int reaches(CONDENSATION *condensation, int from, int to)
+{
+    return from != to && get_bit(condensation->reach, condensation->component[from],
+                                 condensation->component[to]);
+}
+
+/** @brief Frees up the components from memory.
+ *
+ *   @param condensation the components
+ *   @return void
+ */
+void free_condensation(CONDENSATION *condensation);
+
+#endif
@@ -0,0 +1,177 @@
+#include "search.h"
+
+/** @brief Number of bits in each word of the visited bitmaps. */
+#define SEEN_BITS 64
+
+/** @brief Checks whether a city is marked in a visited bitmap.
+ *
+ *   @param seen the visited bitmap
+ *   @param city the city
+ *   @return 1 if the city is marked or 0 otherwise
+ */
+static inline int is_seen(const unsigned long long *seen, int city)
+{
+    return (int)((seen[city / SEEN_BITS] >> (city % SEEN_BITS)) & 1ULL);
+}
+
+/** @brief Marks a city in a visited bitmap.
+ *
+ *   @param seen the visited bitmap
+ *   @param city the city
+ *   @return void
+ */
+static inline void mark_seen(unsigned long long *seen, int city)
+{
+    seen[city / SEEN_BITS] |= 1ULL << (city % SEEN_BITS);
+}
+
+/** @brief Expands one level of a breadth-first search.
+ *
+ *   Every city of the level adds its unseen neighbors to the end of the queue.
+ *
+ *   @param graph      the links to follow
+ *   @param queue      the cities of the search, the level from *head to *tail
+ *   @param head       the start of the level, moved to the start of the next one
+ *   @param tail       the end of the level, moved to the end of the next one
+ *   @param seen       the visited bitmap of the search
+ *   @param parent     the city each city is reached from
+ *   @param other_seen the visited bitmap of the search from the other side
+ *   @return the city where the two searches meet, or -1 if they have not met
+ */
+static int expand_level(GRAPH *graph, int *queue, int *head, int *tail, unsigned long long *seen,
+                        int *parent, const unsigned long long *other_seen)
+{
+    int level_end = *tail;
+
+    for (; *head < level_end; (*head)++)
+    {
+        int city = queue[*head];
+
+        for (long link = graph->offsets[city]; link < graph->offsets[city + 1]; link++)
+        {
+            int next = graph->targets[link];
+
+            if (is_seen(seen, next))
+            {
+                continue;
+            }
+            mark_seen(seen, next);
+            parent[next] = city;
+            queue[(*tail)++] = next;
+
+            if (is_seen(other_seen, next))
+            {
+                return next;
+            }
+        }
+    }
+    return -1;
+}
+
+SEARCH *new_search(GRAPH *graph, GRAPH *reverse)
+{
+    SEARCH *search = (SEARCH *)malloc(sizeof(SEARCH));
+    size_t words = ((size_t)graph->city_count + SEEN_BITS - 1) / SEEN_BITS + 1;
+    size_t cities = (size_t)graph->city_count + 1;
+
+    if (search == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    search->graph = graph;
+    search->reverse = reverse;
+    search->forward_seen = (unsigned long long *)calloc(words, sizeof(unsigned long long));
+    search->backward_seen = (unsigned long long *)calloc(words, sizeof(unsigned long long));
+    search->forward_parent = (int *)malloc(cities * sizeof(int));
+    search->backward_parent = (int *)malloc(cities * sizeof(int));
+    search->forward_queue = (int *)malloc(cities * sizeof(int));
+    search->backward_queue = (int *)malloc(cities * sizeof(int));
+
+    if (search->forward_seen == NULL || search->backward_seen == NULL ||
+        search->forward_parent == NULL || search->backward_parent == NULL ||
+        search->forward_queue == NULL || search->backward_queue == NULL)
+    {
+        printf("Error: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    return search;
+}
+
+void free_search(SEARCH *search)
+{
+    free(search->forward_seen);
+    free(search->backward_seen);
+    free(search->forward_parent);
+    free(search->backward_parent);
+    free(search->forward_queue);
+    free(search->backward_queue);
+    free(search);
+}
+
+int find_path(SEARCH *search, int start_city, int end_city, int *path)
+{
+    int forward_head = 0, forward_tail = 0, backward_head = 0, backward_tail = 0;
+    int meet = -1, length = 0;
+
+    if (start_city < 0 || start_city >= search->graph->city_count || end_city < 0 ||
+        end_city >= search->graph->city_count || start_city == end_city)
+    {
+        return 0;
+    }
+
+    mark_seen(search->forward_seen, start_city);
+    search->forward_queue[forward_tail++] = start_city;
+    mark_seen(search->backward_seen, end_city);
+    search->backward_queue[backward_tail++] = end_city;
+
+    /* Expands the smaller level, until the searches meet or one of them runs out of cities. */
+    while (meet == -1 && forward_head < forward_tail && backward_head < backward_tail)
+    {
+        if (forward_tail - forward_head <= backward_tail - backward_head)
+        {
+            meet = expand_level(search->graph, search->forward_queue, &forward_head,
+                                &forward_tail, search->forward_seen, search->forward_parent,
+                                search->backward_seen);
+        }
+        else
+        {
+            meet = expand_level(search->reverse, search->backward_queue, &backward_head,
+                                &backward_tail, search->backward_seen, search->backward_parent,
+                                search->forward_seen);
+        }
+    }
+
+    if (meet != -1)
+    {
+        /* From the meeting city back to the start, then reversed, then on to the end. */
+        for (int city = meet; city != start_city; city = search->forward_parent[city])
+        {
+            path[length++] = city;
+        }
+        path[length++] = start_city;
+        for (int i = 0, j = length - 1; i < j; i++, j--)
+        {
+            int tmp = path[i];
+            path[i] = path[j];
+            path[j] = tmp;
+        }
+        for (int city = meet; city != end_city;)
+        {
+            city = search->backward_parent[city];
+            path[length++] = city;
+        }
+    }
+
+    /* Clears only the cities this search has reached. */
+    for (int i = 0; i < forward_tail; i++)
+    {
+        search->forward_seen[search->forward_queue[i] / SEEN_BITS] = 0;
+    }
+    for (int i = 0; i < backward_tail; i++)
+    {
+        search->backward_seen[search->backward_queue[i] / SEEN_BITS] = 0;
+    }
+    return length;
+}
@@ -0,0 +1,60 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "graph.h"
+
+/** @brief Represents the memory of a bidirectional breadth-first search between two cities.
+ *
+ *   The memory is allocated once for all the cities and reused by each search. Only the
+ *   cities a search reaches are cleared after it, so a search that stops early costs as much
+ *   as the cities it has reached.
+ */
+typedef struct
+{
+    GRAPH *graph;                      /* the links between the cities */
+    GRAPH *reverse;                    /* the links between the cities, reversed */
+    unsigned long long *forward_seen;  /* a bit for each city reached from the starting city */
+    unsigned long long *backward_seen; /* a bit for each city that reaches the ending city */
+    int *forward_parent;               /* the city before each city reached from the start */
+    int *backward_parent;              /* the city after each city that reaches the end */
+    int *forward_queue;                /* cities reached from the start, level by level */
+    int *backward_queue;               /* cities that reach the end, level by level */
+} SEARCH;
+
+/** @brief Creates the memory for searches through a graph.
+ *
+ *   Searches on many threads each need their own memory, but can share the graphs.
+ *
+ *   @param graph   the links between the cities, kept until free_search()
+ *   @param reverse the links reversed, as built by reverse_graph(), kept until free_search()
+ *   @return the new search
+ */
+SEARCH *new_search(GRAPH *graph, GRAPH *reverse);
+
+/** @brief Frees up the memory of the searches from memory.
+ *
+ *   The graphs are not freed.
+ *
+ *   @param search the search
+ *   @return void
+ */
+void free_search(SEARCH *search);
+
+/** @brief Finds the shortest path between two cities.
+ *
+ *   A breadth-first search goes forward from the starting city and another goes backward
+ *   from the ending city, a whole level at a time, always on the side with the smaller
+ *   level. The search stops as soon as the two meet. A city never has a path to itself.
+ *
+ *   @param search     the memory of the searches
+ *   @param start_city the starting city
+ *   @param end_city   the ending city
+ *   @param path       the cities of the path, room for all the cities of the graph
+ *   @return the number of cities of the path, or 0 if no path exists
+ */
+int find_path(SEARCH *search, int start_city, int end_city, int *path);
+
+#endif
@@ -0,0 +1,351 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "batch.h"
+
+void batch_encode(char **huffman_table, char *input, char *output_dir, int thread_count)
+{
+    int i = 0;
+    BATCH_JOB job;
+    pthread_t *workers = NULL;
+
+    job.input_files = list_batch_files(input, &job.file_count);
+    job.output_files = batch_output_files(job.input_files, job.file_count, output_dir);
+    job.next_file = 0;
+    job.failed_files = 0;
+    job.output_dir = output_dir;
+    job.huffman_table = huffman_table;
+    pthread_mutex_init(&job.lock, NULL);
+
+    /* By default there is one worker for each processor. */
+    if (thread_count <= 0)
+    {
+        thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    /* More workers than files would have nothing to do. */
+    if (thread_count > job.file_count)
+    {
+        thread_count = job.file_count;
+    }
+    if (thread_count < 1)
+    {
+        thread_count = 1;
+    }
+
+    workers = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    if (workers == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < thread_count; i++)
+    {
+        if (pthread_create(&workers[i], NULL, batch_worker, &job) != 0)
+        {
+            printf("Error: Could not create worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (i = 0; i < thread_count; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+
+    printf("Batch encoding done. %d of %d files encoded in \"%s\"\n",
+           job.file_count - job.failed_files, job.file_count, output_dir);
+
+    pthread_mutex_destroy(&job.lock);
+    for (i = 0; i < job.file_count; i++)
+    {
+        free(job.input_files[i]);
+        free(job.output_files[i]);
+    }
+    free(job.input_files);
+    free(job.output_files);
+    free(workers);
+}
+
+char **list_batch_files(char *input, int *file_count)
+{
+    int capacity = 16;
+    char **files = NULL;
+    char line[4096];
+    struct stat info;
+
+    *file_count = 0;
+    files = (char **)malloc(capacity * sizeof(char *));
+    if (files == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (stat(input, &info) != 0)
+    {
+        printf("\"%s\" file cannot be opened\n", input);
+        exit(EXIT_FAILURE);
+    }
+
+    if (S_ISDIR(info.st_mode))
+    {
+        DIR *dir = NULL;
+        struct dirent *entry = NULL;
+
+        if ((dir = opendir(input)) == NULL)
+        {
+            printf("\"%s\" directory cannot be opened\n", input);
+            exit(EXIT_FAILURE);
+        }
+
+        /* Every regular file of the directory is part of the batch. */
+        while ((entry = readdir(dir)) != NULL)
+        {
+            snprintf(line, sizeof(line), "%s/%s", input, entry->d_name);
+            if (stat(line, &info) != 0 || !S_ISREG(info.st_mode))
+            {
+                continue;
+            }
+            if (*file_count == capacity)
+            {
+                capacity *= 2;
+                files = (char **)realloc(files, capacity * sizeof(char *));
+                if (files == NULL)
+                {
+                    printf("Error: Unable to Allocate Memory using realloc\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            files[(*file_count)++] = strdup(line);
+        }
+        closedir(dir);
+    }
+    else
+    {
+        FILE *fp = NULL;
+
+        if ((fp = fopen(input, "r")) == NULL)
+        {
+            printf("\"%s\" file cannot be opened\n", input);
+            exit(EXIT_FAILURE);
+        }
+
+        /* Each line of the list is the path of one file. Empty lines are ignored. */
+        while (fgets(line, sizeof(line), fp) != NULL)
+        {
+            line[strcspn(line, "\r\n")] = '\0';
+            if (line[0] == '\0')
+            {
+                continue;
+            }
+            if (*file_count == capacity)
+            {
+                capacity *= 2;
+                files = (char **)realloc(files, capacity * sizeof(char *));
+                if (files == NULL)
+                {
+                    printf("Error: Unable to Allocate Memory using realloc\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            files[(*file_count)++] = strdup(line);
+        }
+        fclose(fp);
+    }
+    return files;
+}
+
+/** @brief Gets the name of a file without its directories.
+ *
+ *   @param path the path of the file
+ *   @return the name, inside path
+ */
+static char *base_name(char *path)
+{
+    char *name = strrchr(path, '/');
+
+    return (name == NULL) ? path : name + 1;
+}
+
+/** @brief Compares two file names, for qsort() and bsearch().
+ *
+ *   @param a the first name, as a char **
+ *   @param b the second name, as a char **
+ *   @return less than, equal to or more than 0, like strcmp()
+ */
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/** @brief Checks whether a name is in a sorted array of names, and how many times.
+ *
+ *   @param names the names, sorted by compare_names()
+ *   @param count the number of names
+ *   @param name  the name to look for
+ *   @return the number of times the name is there, 0, 1 or 2 for more than one
+ */
+static int count_name(char **names, int count, char *name)
+{
+    char **found = (char **)bsearch(&name, names, count, sizeof(char *), compare_names);
+    long place = 0;
+
+    if (found == NULL)
+    {
+        return 0;
+    }
+    /* Equal names are next to each other. */
+    place = found - names;
+    if ((place > 0 && strcmp(names[place - 1], name) == 0) ||
+        (place + 1 < count && strcmp(names[place + 1], name) == 0))
+    {
+        return 2;
+    }
+    return 1;
+}
+
+char **batch_output_files(char **input_files, int file_count, char *output_dir)
+{
+    char **files = (char **)malloc(((size_t)file_count + 1) * sizeof(char *));
+    char **names = (char **)malloc(((size_t)file_count + 1) * sizeof(char *));
+    char stem[4096]; /* The new name of a file whose name is repeated. */
+    char path[4096];
+
+    if (files == NULL || names == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The names are sorted once, so each one is looked up instead of compared with all. */
+    for (int i = 0; i < file_count; i++)
+    {
+        names[i] = base_name(input_files[i]);
+    }
+    qsort(names, file_count, sizeof(char *), compare_names);
+
+    for (int i = 0; i < file_count; i++)
+    {
+        char *name = base_name(input_files[i]);
+
+        /*
+         * A repeated name gets ".<i>", again until no file of the batch has that name. New
+         * names end with the position of their file, so two of them are never the same.
+         */
+        if (count_name(names, file_count, name) > 1)
+        {
+            size_t length = (size_t)snprintf(stem, sizeof(stem), "%s.%d", name, i);
+
+            while (length < sizeof(stem) && count_name(names, file_count, stem) > 0)
+            {
+                length += (size_t)snprintf(stem + length, sizeof(stem) - length, ".%d", i);
+            }
+            name = stem;
+        }
+        if (snprintf(path, sizeof(path), "%s/%s.enc", output_dir, name) >= (int)sizeof(path))
+        {
+            printf("\"%s\" file name is too long\n", input_files[i]);
+            exit(EXIT_FAILURE);
+        }
+        if ((files[i] = strdup(path)) == NULL)
+        {
+            printf("Error: Could not allocate memory using malloc\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    free(names);
+    return files;
+}
+
+void *batch_worker(void *job)
+{
+    BATCH_JOB *batch = (BATCH_JOB *)job;
+    char temporary_file[4096];
+
+    while (1)
+    {
+        int index = 0;
+        int result = 0;
+        char *output_file = NULL;
+        FILE *fp_read = NULL, *fp_write = NULL;
+
+        /* Takes the next file that no other worker has taken. */
+        pthread_mutex_lock(&batch->lock);
+        index = batch->next_file++;
+        pthread_mutex_unlock(&batch->lock);
+
+        if (index >= batch->file_count)
+        {
+            break;
+        }
+
+        /* The encoded file only gets its name once it is complete. */
+        output_file = batch->output_files[index];
+        snprintf(temporary_file, sizeof(temporary_file), "%s.tmp", output_file);
+
+        if ((fp_read = fopen(batch->input_files[index], "r")) == NULL)
+        {
+            printf("\"%s\" file cannot be opened\n", batch->input_files[index]);
+        }
+        else if ((fp_write = fopen(temporary_file, "w")) == NULL)
+        {
+            printf("Error: Unable to create \"%s\" output file\n", temporary_file);
+        }
+        else if ((result = encode_stream(batch->huffman_table, fp_read, fp_write)) == -1)
+        {
+            printf("\"%s\" cannot have ASCII characters with value above 127\n",
+                   batch->input_files[index]);
+        }
+        else if (result != 0)
+        {
+            printf("Error: Unable to encode \"%s\" in \"%s\"\n", batch->input_files[index],
+                   temporary_file);
+        }
+        else
+        {
+            int written = (fclose(fp_write) == 0);
+
+            fp_write = NULL;
+            if (written && rename(temporary_file, output_file) == 0)
+            {
+                fclose(fp_read);
+                continue;
+            }
+            printf("Error: Unable to write \"%s\" output file\n", output_file);
+        }
+
+        /* Reaching here means the file could not be encoded. */
+        if (fp_read != NULL)
+        {
+            fclose(fp_read);
+        }
+        if (fp_write != NULL)
+        {
+            fclose(fp_write);
+        }
+        unlink(temporary_file);
+        pthread_mutex_lock(&batch->lock);
+        batch->failed_files++;
+        pthread_mutex_unlock(&batch->lock);
+    }
+    return NULL;
+}
+
+#ifdef TEST_B
+int main(int argc, char **argv)
+{
+    char *prob_file = argv[1];
+    char *input = argv[2];
+    char *output_dir = argv[3];
+
+    NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+    char **huffman_table = generate_huffman_table(huffman_tree_root);
+    batch_encode(huffman_table, input, output_dir, 0);
+    free_huffman_tree(huffman_tree_root);
+    free_huffman_table(huffman_table);
+    return 0;
+}
+#endif
@@ -0,0 +1,76 @@
+#ifndef BATCH
+#define BATCH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "huffman_tree.h"
+#include "encoder.h"
+
+/** @brief The files of a batch and the progress of the workers encoding them.
+ *
+ *  Workers take the next file to encode from next_file, which is protected by lock.
+ */
+typedef struct {
+    char **input_files;   /* Paths of the files to encode. */
+    char **output_files;  /* Paths of the encoded files, one for each input file. */
+    int file_count;       /* Number of files to encode. */
+    int next_file;        /* Index of the next file a worker will take. */
+    int failed_files;     /* Number of files that could not be encoded. */
+    char *output_dir;     /* Directory to save the encoded files in. */
+    char **huffman_table; /* The Huffman table shared by all the workers. */
+    pthread_mutex_t lock;
+} BATCH_JOB;
+
+/** @brief Encodes many files with one Huffman table.
+ *
+ *   The Huffman table is built once by the caller and shared by a pool of worker threads,
+ *   which take the files one by one. Each file is saved in output_dir with the same name
+ *   and the ".enc" extension, see batch_output_files(). It is written under a temporary name
+ *   first and renamed when it is complete, so a file that cannot be encoded leaves nothing
+ *   behind. Files that cannot be read or written are reported and skipped.
+ *
+ *   @param huffman_table the Huffman table to get the Huffman codes
+ *   @param input         a directory with the files to encode, or a file with one path per line
+ *   @param output_dir    the directory to save the encoded files in
+ *   @param thread_count  the number of worker threads, or 0 to use one per processor
+ *   @return void
+ */
+void batch_encode(char **huffman_table, char *input, char *output_dir, int thread_count);
+
+/** @brief Finds the files of a batch.
+ *
+ *   If input is a directory, its regular files are used. Otherwise input is read as a
+ *   list of paths, one per line.
+ *
+ *   @param input      the directory or the file list
+ *   @param file_count the number of files found
+ *   @return the paths of the files
+ */
+char **list_batch_files(char *input, int *file_count);
+
+/** @brief Chooses the path of the encoded file of each file of a batch.
+ *
+ *   The encoded file is output_dir/<name>.enc, name being the input file name without its
+ *   directories. Files with the same name in different directories would overwrite each
+ *   other, so each of them gets its position in the batch as well: output_dir/<name>.<i>.enc.
+ *   If a file of the batch is already called <name>.<i>, ".<i>" is added again. The names
+ *   are sorted once and looked up, so a batch of N files takes N log N comparisons.
+ *
+ *   @param input_files the paths of the files
+ *   @param file_count  the number of files
+ *   @param output_dir  the directory to save the encoded files in
+ *   @return the paths of the encoded files
+ */
+char **batch_output_files(char **input_files, int file_count, char *output_dir);
+
+/** @brief Worker thread of batch_encode().
+ *
+ *   Takes files from the job until there are none left and encodes each one.
+ *
+ *   @param job the BATCH_JOB shared by all the workers
+ *   @return NULL
+ */
+void *batch_worker(void *job);
+
+#endif
@@ -0,0 +1,289 @@
+#include "codegen.h"
+#include "fsm_decoder.h"
+
+void emit_c_codebook(NODE *huffman_tree_root, char **huffman_table, char *prob_file,
+                     char *header_file)
+{
+    int i = 0, j = 0;
+    int offset = 0;     /* Offset of the current code in the bits array. */
+    int max_length = 0; /* Length of the longest code. */
+    FSM *fsm = build_fsm_decoder(huffman_tree_root);
+    FILE *fp = NULL;
+
+    if ((fp = fopen(header_file, "w")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", header_file);
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        if ((int)strlen(huffman_table[i]) > max_length)
+        {
+            max_length = strlen(huffman_table[i]);
+        }
+    }
+
+    fprintf(fp, "/* Generated by \"huffman --emit-c %s\". Do not edit. */\n", prob_file);
+    fprintf(fp, "#ifndef HUFFMAN_CODEBOOK\n#define HUFFMAN_CODEBOOK\n\n");
+    fprintf(fp, "#include <stdio.h>\n#include <string.h>\n\n");
+    fprintf(fp, "/* Number of characters read and written at a time. */\n");
+    fprintf(fp, "#define HUFFMAN_CODEBOOK_BLOCK %d\n\n", CODEGEN_BLOCK_SIZE);
+    fprintf(fp, "/* Length of the longest code. */\n");
+    fprintf(fp, "#define HUFFMAN_CODEBOOK_MAX_LENGTH %d\n\n", max_length);
+
+    /* All the codes one after the other, as '0' and '1' characters. */
+    fprintf(fp, "/* Codes of all the characters, one after the other. */\n");
+    fprintf(fp, "static const char huffman_codebook_bits[] = {");
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        char *bit = huffman_table[i];
+
+        for (; *bit != '\0'; bit++, offset++)
+        {
+            fprintf(fp, "%s'%c',", (offset % 16 == 0) ? "\n    " : " ", *bit);
+        }
+    }
+    fprintf(fp, "\n};\n\n");
+
+    /* Where the code of each character starts in huffman_codebook_bits. */
+    fprintf(fp, "/* Start of the code of each character in huffman_codebook_bits. */\n");
+    fprintf(fp, "static const unsigned short huffman_codebook_offset[%d] = {", MAX_ASCII);
+    for (i = 0, offset = 0; i < MAX_ASCII; i++)
+    {
+        fprintf(fp, "%s%d,", (i % 12 == 0) ? "\n    " : " ", offset);
+        offset += strlen(huffman_table[i]);
+    }
+    fprintf(fp, "\n};\n\n");
+
+    fprintf(fp, "/* Length of the code of each character. */\n");
+    fprintf(fp, "static const unsigned char huffman_codebook_length[%d] = {", MAX_ASCII);
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        fprintf(fp, "%s%d,", (i % 16 == 0) ? "\n    " : " ", (int)strlen(huffman_table[i]));
+    }
+    fprintf(fp, "\n};\n\n");
+
+    /* The children of each state, for the last bits that do not fill a byte. */
+    fprintf(fp, "/*\n * Row n holds the children of internal node n (the root is 0). A child is\n");
+    fprintf(fp, " * the number of an internal node, or -(character + 1) for a leaf.\n */\n");
+    fprintf(fp, "static const short huffman_codebook_tree[%d][2] = {\n", fsm->state_count);
+    for (i = 0; i < fsm->state_count; i++)
+    {
+        fprintf(fp, "    {%d, %d},\n", fsm->children[i][0], fsm->children[i][1]);
+    }
+    fprintf(fp, "};\n\n");
+
+    /* The table of the finite-state machine, the same as the one -d decodes with. */
+    fprintf(fp, "/* What reading a byte of 8 bits at an internal node decodes. */\n");
+    fprintf(fp, "typedef struct {\n"
+                "    unsigned char next_state;   /* The internal node after the 8 bits. */\n"
+                "    unsigned char symbol_count; /* The number of characters decoded. */\n"
+                "    char symbols[8];            /* The characters decoded. */\n"
+                "} HUFFMAN_CODEBOOK_ENTRY;\n\n");
+    fprintf(fp, "/* Entry 256 * node + byte is what reading byte at internal node decodes. */\n");
+    fprintf(fp, "static const HUFFMAN_CODEBOOK_ENTRY huffman_codebook_fsm[%d] = {\n",
+            fsm->state_count * 256);
+    for (i = 0; i < fsm->state_count * 256; i++)
+    {
+        FSM_ENTRY *entry = &fsm->table[i];
+
+        /* C does not allow empty braces, so no character is written as {0}. */
+        fprintf(fp, "    {%d, %d, {%d", entry->next_state, entry->symbol_count,
+                (entry->symbol_count == 0) ? 0 : entry->symbols[0]);
+        for (j = 1; j < entry->symbol_count; j++)
+        {
+            fprintf(fp, ", %d", entry->symbols[j]);
+        }
+        fprintf(fp, "}},\n");
+    }
+    fprintf(fp, "};\n\n");
+
+    /* Encode function, copies the codes of a block to a buffer written with one fwrite(). */
+    fprintf(fp,
+        "/* Encodes in to out. Returns the number of characters encoded, or -1 on a character\n"
+        " * outside the codebook or when in cannot be read or out cannot be written. */\n"
+        "static inline long huffman_codebook_encode(FILE *in, FILE *out)\n"
+        "{\n"
+        "    char input[HUFFMAN_CODEBOOK_BLOCK];\n"
+        "    /* A code is several bits, so the output is written 4 blocks at a time. */\n"
+        "    char output[4 * HUFFMAN_CODEBOOK_BLOCK + HUFFMAN_CODEBOOK_MAX_LENGTH];\n"
+        "    size_t read_count = 0, output_size = 0, i = 0;\n"
+        "    long count = 0;\n\n"
+        "    while ((read_count = fread(input, 1, sizeof(input), in)) > 0)\n"
+        "    {\n"
+        "        for (i = 0; i < read_count; i++)\n"
+        "        {\n"
+        "            int character = (unsigned char)input[i];\n\n"
+        "            if (character >= %d)\n"
+        "            {\n"
+        "                return -1;\n"
+        "            }\n"
+        "            memcpy(output + output_size,\n"
+        "                   huffman_codebook_bits + huffman_codebook_offset[character],\n"
+        "                   huffman_codebook_length[character]);\n"
+        "            output_size += huffman_codebook_length[character];\n"
+        "            /* The buffer is written once it has no room for another code. */\n"
+        "            if (output_size > 4 * HUFFMAN_CODEBOOK_BLOCK)\n"
+        "            {\n"
+        "                if (fwrite(output, 1, output_size, out) != output_size)\n"
+        "                {\n"
+        "                    return -1;\n"
+        "                }\n"
+        "                output_size = 0;\n"
+        "            }\n"
+        "        }\n"
+        "        count += (long)read_count;\n"
+        "    }\n"
+        "    if (ferror(in) || fwrite(output, 1, output_size, out) != output_size)\n"
+        "    {\n"
+        "        return -1;\n"
+        "    }\n"
+        "    return count;\n"
+        "}\n\n", MAX_ASCII);
+
+    /*
+     * Decode function, one lookup in the table of the finite-state machine for 8 bits, which
+     * are packed 8 characters at a time like fsm_decode_text() does.
+     */
+    fprintf(fp,
+        "/* Decodes in to out, ignoring characters other than '0' and '1'. Returns the number\n"
+        " * of characters decoded, or -1 when in cannot be read or out cannot be written. */\n"
+        "static inline long huffman_codebook_decode(FILE *in, FILE *out)\n"
+        "{\n"
+        "    char input[HUFFMAN_CODEBOOK_BLOCK];\n"
+        "    char output[HUFFMAN_CODEBOOK_BLOCK]; /* 8 bits decode to at most 8 characters. */\n"
+        "    size_t read_count = 0, output_size = 0, i = 0;\n"
+        "    int state = 0, pending = 0, pending_count = 0, next = 0;\n"
+        "    long count = 0;\n\n"
+        "    while ((read_count = fread(input, 1, sizeof(input), in)) > 0)\n"
+        "    {\n"
+        "        output_size = 0;\n"
+        "        for (i = 0; i < read_count;)\n"
+        "        {\n"
+        "            const HUFFMAN_CODEBOOK_ENTRY *entry = NULL;\n\n"
+        "#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__\n"
+        "            /* 8 characters that are all '0' or '1' are packed at once. */\n"
+        "            if (pending_count == 0 && i + 8 <= read_count)\n"
+        "            {\n"
+        "                unsigned long long word = 0;\n\n"
+        "                memcpy(&word, input + i, 8);\n"
+        "                if ((word & 0xFEFEFEFEFEFEFEFEULL) == 0x3030303030303030ULL)\n"
+        "                {\n"
+        "                    pending = (int)(((word & 0x0101010101010101ULL) *\n"
+        "                                     0x8040201008040201ULL) >> 56);\n"
+        "                    pending_count = 8;\n"
+        "                    i += 8;\n"
+        "                }\n"
+        "            }\n"
+        "#endif\n"
+        "            if (pending_count < 8)\n"
+        "            {\n"
+        "                if (input[i] == '0' || input[i] == '1')\n"
+        "                {\n"
+        "                    pending = (pending << 1) | (input[i] - '0');\n"
+        "                    pending_count++;\n"
+        "                }\n"
+        "                i++;\n"
+        "                if (pending_count < 8)\n"
+        "                {\n"
+        "                    continue;\n"
+        "                }\n"
+        "            }\n"
+        "            entry = &huffman_codebook_fsm[256 * state + pending];\n"
+        "            memcpy(output + output_size, entry->symbols, entry->symbol_count);\n"
+        "            output_size += entry->symbol_count;\n"
+        "            state = entry->next_state;\n"
+        "            pending = 0;\n"
+        "            pending_count = 0;\n"
+        "        }\n"
+        "        if (fwrite(output, 1, output_size, out) != output_size)\n"
+        "        {\n"
+        "            return -1;\n"
+        "        }\n"
+        "        count += (long)output_size;\n"
+        "    }\n"
+        "    if (ferror(in))\n"
+        "    {\n"
+        "        return -1;\n"
+        "    }\n\n"
+        "    /* The last bits that do not fill a byte, one at a time. */\n"
+        "    while (pending_count > 0)\n"
+        "    {\n"
+        "        pending_count--;\n"
+        "        next = huffman_codebook_tree[state][(pending >> pending_count) & 1];\n"
+        "        if (next < 0)\n"
+        "        {\n"
+        "            if (fputc(-next - 1, out) == EOF)\n"
+        "            {\n"
+        "                return -1;\n"
+        "            }\n"
+        "            count++;\n"
+        "            next = 0;\n"
+        "        }\n"
+        "        state = next;\n"
+        "    }\n"
+        "    return count;\n"
+        "}\n\n");
+
+    fprintf(fp, "#endif\n");
+    if (fclose(fp) != 0)
+    {
+        printf("Error: Unable to write \"%s\" output file\n", header_file);
+        exit(EXIT_FAILURE);
+    }
+    printf("Codebook saved in \"%s\"\n", header_file);
+    free_fsm_decoder(fsm);
+}
+
+void number_internal_nodes(NODE *current_node, NODE **nodes, int *node_count)
+{
+    /* Leaves are not numbered. */
+    if (current_node->left == NULL && current_node->right == NULL)
+    {
+        return;
+    }
+
+    nodes[(*node_count)++] = current_node;
+
+    if (current_node->left != NULL)
+    {
+        number_internal_nodes(current_node->left, nodes, node_count);
+    }
+
+    if (current_node->right != NULL)
+    {
+        number_internal_nodes(current_node->right, nodes, node_count);
+    }
+}
+
+int find_node_number(NODE **nodes, int node_count, NODE *node)
+{
+    int i = 0;
+
+    for (i = 0; i < node_count; i++)
+    {
+        if (nodes[i] == node)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#ifdef TEST_G
+int const MAX_ASCII = 128;
+
+int main(int argc, char **argv)
+{
+    char *prob_file = argv[1];
+    char *header_file = argv[2];
+
+    NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+    char **huffman_table = generate_huffman_table(huffman_tree_root);
+    emit_c_codebook(huffman_tree_root, huffman_table, prob_file, header_file);
+    free_huffman_tree(huffman_tree_root);
+    free_huffman_table(huffman_table);
+    return 0;
+}
+#endif
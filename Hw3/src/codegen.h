@@ -0,0 +1,52 @@
+#ifndef CODEGEN
+#define CODEGEN
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "huffman_tree.h"
+
+/** @brief Number of characters the functions of the generated header read at a time.
+ *
+ *  Their buffers are on the stack: the encoder needs 5 times this size, the decoder twice.
+ */
+#define CODEGEN_BLOCK_SIZE 16384
+
+/** @brief Generates a C header specialized for one codebook.
+ *
+ *   The header holds the codes, their lengths and the table of the finite-state machine of
+ *   build_fsm_decoder() as static const arrays, plus inline functions that encode and decode
+ *   using those arrays. Both read and write CODEGEN_BLOCK_SIZE characters at a time, and the
+ *   decoder decodes 8 bits with each lookup, like -d. A program that includes the header
+ *   does not need the probability file or the Huffman binary tree at run time. The encoded
+ *   data is in the same format as the one produced by encode().
+ *
+ *   @param huffman_tree_root the root of the Huffman binary tree
+ *   @param huffman_table     the Huffman table to get the Huffman codes
+ *   @param prob_file         the probability file the codebook was built from
+ *   @param header_file       the file name of the header to generate
+ *   @return void
+ */
+void emit_c_codebook(NODE *huffman_tree_root, char **huffman_table, char *prob_file,
+                     char *header_file);
+
+/** @brief Numbers the internal nodes of the Huffman binary tree in preorder.
+ *
+ *   The root is numbered 0. Leaves are not numbered.
+ *
+ *   @param current_node the node the recursion is currently on
+ *   @param nodes        array to save the internal nodes in by their number
+ *   @param node_count   the number of internal nodes numbered so far
+ *   @return void
+ */
+void number_internal_nodes(NODE *current_node, NODE **nodes, int *node_count);
+
+/** @brief Finds the number an internal node was given by number_internal_nodes().
+ *
+ *   @param nodes      the internal nodes by their number
+ *   @param node_count the number of internal nodes
+ *   @param node       the node to find
+ *   @return the number of the node
+ */
+int find_node_number(NODE **nodes, int node_count, NODE *node);
+
+#endif
@@ -0,0 +1,316 @@
+#include "compress.h"
+
+void compress_file(char *data_file, char *compressed_file)
+{
+    int i = 0;
+    int max_length = 0;       /* Length of the longest Huffman code. */
+    unsigned int end_checksum = block_checksum(0, 0, NULL);
+    long file_size = 0;
+    size_t data_size = 0, position = 0;
+    char *data = NULL;
+    unsigned char *output = NULL;
+    unsigned char code_lengths[CODE_LENGTHS_SIZE];
+    unsigned long long *count_char = (unsigned long long *)calloc(MAX_ASCII,
+                                                                  sizeof(unsigned long long));
+    float *prob_table = (float *)calloc(MAX_ASCII, sizeof(float));
+    NODE *huffman_tree_root = NULL;
+    char **huffman_table = NULL;
+    BIT_CODE *bit_codes = NULL;
+    PAIR_CODE *pair_codes = NULL;
+    FILE *fp_read = NULL, *fp_write = NULL;
+
+    if (count_char == NULL || prob_table == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp_read = fopen(data_file, "rb")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", data_file);
+        exit(EXIT_FAILURE);
+    }
+
+    /* The data file is read once and both passes use the copy in memory. */
+    fseek(fp_read, 0, SEEK_END);
+    if ((file_size = ftell(fp_read)) < 0)
+    {
+        printf("\"%s\" file cannot be read\n", data_file);
+        exit(EXIT_FAILURE);
+    }
+    data_size = (size_t)file_size;
+    fseek(fp_read, 0, SEEK_SET);
+    data = (char *)malloc(data_size + 1);
+    if (data == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+    data_size = fread(data, 1, data_size, fp_read);
+    fclose(fp_read);
+
+    /* First pass: counts the characters, like count_characters() does for a file. */
+    for (position = 0; position < data_size; position++)
+    {
+        unsigned char character = (unsigned char)data[position];
+
+        if (character >= MAX_ASCII)
+        {
+            printf("File cannot have ASCII characters with value above 127\n");
+            exit(EXIT_FAILURE);
+        }
+        count_char[character]++;
+    }
+    /* An empty file keeps all the probabilities at 0. */
+    if (data_size > 0)
+    {
+        calc_probability(count_char, (unsigned long long)data_size, prob_table);
+    }
+
+    /* Only the code lengths of the Huffman binary tree are kept. */
+    huffman_tree_root = build_huffman_tree(prob_table);
+    huffman_table = generate_huffman_table(huffman_tree_root);
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        code_lengths[i] = (unsigned char)strlen(huffman_table[i]);
+        if (code_lengths[i] > max_length)
+        {
+            max_length = code_lengths[i];
+        }
+    }
+    free_huffman_tree(huffman_tree_root);
+    free_huffman_table(huffman_table);
+    free(count_char);
+    free(prob_table);
+
+    huffman_table = generate_canonical_table(code_lengths);
+    bit_codes = generate_bit_codes(huffman_table);
+    pair_codes = generate_pair_codes(bit_codes);
+
+    output = (unsigned char *)malloc((size_t)CONTAINER_BLOCK_SIZE * max_length / 8 + 1);
+    if (output == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp_write = fopen(compressed_file, "wb")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", compressed_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if (fwrite(COMPRESSED_MAGIC, 1, 4, fp_write) != 4)
+    {
+        printf("Error: Unable to write \"%s\" output file\n", compressed_file);
+        exit(EXIT_FAILURE);
+    }
+    write_code_lengths(code_lengths, fp_write);
+
+    /* Second pass: encodes the data in memory, one block at a time, then the empty block. */
+    for (position = 0; position < data_size; position += CONTAINER_BLOCK_SIZE)
+    {
+        size_t block_size = data_size - position;
+
+        if (block_size > CONTAINER_BLOCK_SIZE)
+        {
+            block_size = CONTAINER_BLOCK_SIZE;
+        }
+        write_container_block(bit_codes, pair_codes, data + position, block_size, output,
+                              &end_checksum, fp_write);
+    }
+    write_container_block(bit_codes, pair_codes, data, 0, output, &end_checksum, fp_write);
+
+    if (fclose(fp_write) != 0)
+    {
+        printf("Error: Unable to write \"%s\" output file\n", compressed_file);
+        exit(EXIT_FAILURE);
+    }
+    printf("Encoding done. Result in: \"%s\"\n", compressed_file);
+    free(data);
+    free(output);
+    free(bit_codes);
+    free(pair_codes);
+    free_huffman_table(huffman_table);
+}
+
+void decompress_file(char *compressed_file, char *decoded_file)
+{
+    char magic[4];
+    unsigned char code_lengths[CODE_LENGTHS_SIZE];
+    char **huffman_table = NULL;
+    NODE *huffman_tree_root = NULL;
+    FILE *fp_read = NULL, *fp_write = NULL;
+
+    if ((fp_read = fopen(compressed_file, "rb")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", compressed_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if (fread(magic, 1, 4, fp_read) != 4 || memcmp(magic, COMPRESSED_MAGIC, 4) != 0)
+    {
+        printf("\"%s\" is not a self-contained file\n", compressed_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if (read_code_lengths(code_lengths, fp_read) == 0 ||
+        (huffman_table = generate_canonical_table(code_lengths)) == NULL)
+    {
+        printf("The code lengths of \"%s\" are corrupted\n", compressed_file);
+        exit(EXIT_FAILURE);
+    }
+    huffman_tree_root = build_canonical_tree(huffman_table);
+
+    if ((fp_write = fopen(decoded_file, "w")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", decoded_file);
+        exit(EXIT_FAILURE);
+    }
+
+    decode_container_blocks(huffman_tree_root, fp_read, compressed_file, fp_write);
+
+    fclose(fp_read);
+    if (fclose(fp_write) != 0)
+    {
+        printf("Error: Unable to write \"%s\" output file\n", decoded_file);
+        exit(EXIT_FAILURE);
+    }
+    printf("Decoding done. Result in: \"%s\"\n", decoded_file);
+    free_huffman_tree(huffman_tree_root);
+    free_huffman_table(huffman_table);
+}
+
+char **generate_canonical_table(unsigned char *code_lengths)
+{
+    int i = 0, length = 0;
+    int code_size = 0;  /* Number of bits in code. */
+    int overflow = 0;   /* Whether every code of the current length has been used. */
+    char *code = (char *)malloc(MAX_ASCII);
+    char **huffman_table = (char **)calloc(MAX_ASCII, sizeof(char *));
+
+    if (code == NULL || huffman_table == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        if (code_lengths[i] == 0 || code_lengths[i] >= MAX_ASCII)
+        {
+            free(code);
+            free_huffman_table(huffman_table);
+            return NULL;
+        }
+    }
+
+    /* The codes are long, so code is kept as '0' and '1' characters and added to as such. */
+    for (length = 1; length < MAX_ASCII; length++)
+    {
+        for (i = 0; i < MAX_ASCII; i++)
+        {
+            int bit = 0;
+
+            if (code_lengths[i] != length)
+            {
+                continue;
+            }
+            /* More codes than there is room for at this length. */
+            if (overflow == 1)
+            {
+                free(code);
+                free_huffman_table(huffman_table);
+                return NULL;
+            }
+
+            while (code_size < length)
+            {
+                code[code_size++] = '0';
+            }
+            code[code_size] = '\0';
+
+            huffman_table[i] = (char *)malloc(code_size + 1);
+            if (huffman_table[i] == NULL)
+            {
+                printf("Error: Could not allocate memory using malloc\n");
+                exit(EXIT_FAILURE);
+            }
+            strcpy(huffman_table[i], code);
+
+            /* Adds 1 to code. It overflows when the code was all 1 bits. */
+            for (bit = code_size - 1; bit >= 0 && code[bit] == '1'; bit--)
+            {
+                code[bit] = '0';
+            }
+            if (bit >= 0)
+            {
+                code[bit] = '1';
+            }
+            else
+            {
+                overflow = 1;
+            }
+        }
+    }
+    free(code);
+
+    /* Without the overflow some codes were never used, so the tree would be missing leaves. */
+    if (overflow == 0)
+    {
+        free_huffman_table(huffman_table);
+        return NULL;
+    }
+    return huffman_table;
+}
+
+NODE *build_canonical_tree(char **huffman_table)
+{
+    int i = 0;
+    NODE *root = (NODE *)calloc(1, sizeof(NODE));
+
+    if (root == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Follows the code of each character from the root, adding the nodes that are missing. */
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        NODE *current_node = root;
+        char *bit = NULL;
+
+        for (bit = huffman_table[i]; *bit != '\0'; bit++)
+        {
+            NODE **child = (*bit == '0') ? &current_node->left : &current_node->right;
+
+            if (*child == NULL)
+            {
+                *child = (NODE *)calloc(1, sizeof(NODE));
+                if (*child == NULL)
+                {
+                    printf("Error: Could not allocate memory using malloc\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            current_node = *child;
+        }
+        current_node->character = (char)i;
+    }
+    return root;
+}
+
+#ifdef TEST_X
+int main(int argc, char **argv)
+{
+    char *data_file = argv[1];
+    char *compressed_file = argv[2];
+    char *decoded_file = argv[3];
+
+    compress_file(data_file, compressed_file);
+    verify_container(compressed_file, 0);
+    decompress_file(compressed_file, decoded_file);
+    return 0;
+}
+#endif
@@ -0,0 +1,56 @@
+#ifndef COMPRESS
+#define COMPRESS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "prob_table.h"
+#include "huffman_tree.h"
+#include "encoder.h"
+#include "container.h"
+
+/** @brief Encodes a data file into a self-contained file, with no probability file.
+ *
+ *   The data file is read once in memory. The characters are counted there, the Huffman
+ *   codes are built from the counts and the data is encoded from memory. Only the length of
+ *   each code is saved in the file, since the codes are made canonical: the codes of the
+ *   same length are consecutive numbers, in the order of the characters.
+ *
+ *   @param data_file       the file to get the data to encode
+ *   @param compressed_file the file name of the self-contained file to save the encoded data in
+ *   @return void
+ */
+void compress_file(char *data_file, char *compressed_file);
+
+/** @brief Decodes a self-contained file produced by compress_file().
+ *
+ *   The Huffman binary tree is built from the code lengths saved in the file.
+ *
+ *   @param compressed_file the self-contained file to decode
+ *   @param decoded_file    the file name of the output file to save the decoded data in
+ *   @return void
+ */
+void decompress_file(char *compressed_file, char *decoded_file);
+
+/** @brief Generates the canonical Huffman table for the given code lengths.
+ *
+ *   Characters are taken by the length of their code and then by their value. The first
+ *   one gets a code of 0 bits and each of the next ones gets the code after the previous
+ *   one, with 0 bits added at the end while it is shorter than its length.
+ *
+ *   @param code_lengths the length of the code of each character
+ *   @return the Huffman table, or NULL if the lengths do not make a complete prefix code
+ */
+char **generate_canonical_table(unsigned char *code_lengths);
+
+/** @brief Builds the Huffman binary tree of a Huffman table.
+ *
+ *   The table needs to be a complete prefix code, like the ones of
+ *   generate_canonical_table(). Only the leaves have a character.
+ *
+ *   @param huffman_table the Huffman table to get the Huffman codes
+ *   @return the root of the Huffman binary tree
+ */
+NODE *build_canonical_tree(char **huffman_table);
+
+#endif
@@ -0,0 +1,520 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+#include "container.h"
+
+void encode_container(char **huffman_table, char *data_file, char *encoded_file)
+{
+    int i = 0;
+    int max_length = 0;           /* Length of the longest Huffman code. */
+    unsigned int end_checksum = block_checksum(0, 0, NULL);
+    size_t input_size = 0;
+    char *input = NULL;
+    unsigned char *output = NULL;
+    BIT_CODE *bit_codes = generate_bit_codes(huffman_table);
+    PAIR_CODE *pair_codes = generate_pair_codes(bit_codes);
+    FILE *fp_read = NULL, *fp_write = NULL;
+
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        if (bit_codes[i].length > max_length)
+        {
+            max_length = bit_codes[i].length;
+        }
+    }
+
+    input = (char *)malloc(CONTAINER_BLOCK_SIZE);
+    output = (unsigned char *)malloc((size_t)CONTAINER_BLOCK_SIZE * max_length / 8 + 1);
+    if (input == NULL || output == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp_read = fopen(data_file, "rb")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", data_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp_write = fopen(encoded_file, "wb")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if (fwrite(CONTAINER_MAGIC, 1, 4, fp_write) != 4)
+    {
+        printf("Error: Unable to write \"%s\" output file\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Each block of the data file is encoded on its own, the last one is empty. */
+    do
+    {
+        input_size = fread(input, 1, CONTAINER_BLOCK_SIZE, fp_read);
+        write_container_block(bit_codes, pair_codes, input, input_size, output, &end_checksum,
+                              fp_write);
+    } while (input_size > 0);
+
+    fclose(fp_read);
+    if (fclose(fp_write) != 0)
+    {
+        printf("Error: Unable to write \"%s\" output file\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+    printf("Encoding done. Result in: \"%s\"\n", encoded_file);
+    free(input);
+    free(output);
+    free(bit_codes);
+    free(pair_codes);
+}
+
+void write_container_block(BIT_CODE *bit_codes, PAIR_CODE *pair_codes, char *input,
+                           size_t input_size, unsigned char *output, unsigned int *end_checksum,
+                           FILE *fp_write)
+{
+    long bit_count = encode_block_packed(bit_codes, pair_codes, input, input_size, output);
+    size_t byte_count = 0;
+    unsigned int checksum = 0;
+    unsigned char header[BLOCK_HEADER_SIZE];
+
+    if (bit_count < 0)
+    {
+        printf("File cannot have ASCII characters with value above 127\n");
+        exit(EXIT_FAILURE);
+    }
+    byte_count = (bit_count + 7) / 8;
+
+    write_uint32(header, (unsigned int)input_size);
+    write_uint32(header + 4, (unsigned int)bit_count);
+    /* The block that ends the file carries the checksum of the blocks before it. */
+    if (input_size == 0)
+    {
+        checksum = *end_checksum;
+    }
+    else
+    {
+        checksum = block_checksum((unsigned int)input_size, (unsigned int)bit_count, output);
+        *end_checksum = end_block_checksum(*end_checksum, checksum);
+    }
+
+    write_uint32(header, (unsigned int)input_size);
+    write_uint32(header + 4, (unsigned int)bit_count);
+    write_uint32(header + 8, checksum);
+    if (fwrite(header, 1, BLOCK_HEADER_SIZE, fp_write) != BLOCK_HEADER_SIZE ||
+        fwrite(output, 1, byte_count, fp_write) != byte_count)
+    {
+        printf("Error: Unable to write the output file\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void decode_container(NODE *huffman_tree_root, char *encoded_file, char *decoded_file)
+{
+    char magic[4];
+    FILE *fp_read = NULL, *fp_write = NULL;
+
+    if ((fp_read = fopen(encoded_file, "rb")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if (fread(magic, 1, 4, fp_read) != 4 || memcmp(magic, CONTAINER_MAGIC, 4) != 0)
+    {
+        printf("\"%s\" is not a container file\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp_write = fopen(decoded_file, "w")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", decoded_file);
+        exit(EXIT_FAILURE);
+    }
+    decode_container_blocks(huffman_tree_root, fp_read, encoded_file, fp_write);
+
+    fclose(fp_read);
+    if (fclose(fp_write) != 0)
+    {
+        printf("Error: Unable to write \"%s\" output file\n", decoded_file);
+        exit(EXIT_FAILURE);
+    }
+    printf("Decoding done. Result in: \"%s\"\n", decoded_file);
+}
+
+void decode_container_blocks(NODE *huffman_tree_root, FILE *fp_read, char *encoded_file,
+                             FILE *fp_write)
+{
+    int i = 0;
+    int block_count = 0;
+    BLOCK_INFO *blocks = read_block_index(fp_read, &block_count);
+    FSM *fsm = build_fsm_decoder(huffman_tree_root);
+
+    for (i = 0; i < block_count; i++)
+    {
+        size_t byte_count = (blocks[i].bit_count + 7) / 8;
+        unsigned char *input = (unsigned char *)malloc(byte_count + 1);
+        char *output = (char *)malloc(blocks[i].bit_count + 1);
+        size_t output_size = 0;
+
+        if (input == NULL || output == NULL)
+        {
+            printf("Error: Could not allocate memory using malloc\n");
+            exit(EXIT_FAILURE);
+        }
+
+        fseek(fp_read, blocks[i].offset, SEEK_SET);
+        if (fread(input, 1, byte_count, fp_read) != byte_count ||
+            is_intact_block(&blocks[i], input) == 0)
+        {
+            printf("Block %d of \"%s\" is corrupted\n", i, encoded_file);
+            exit(EXIT_FAILURE);
+        }
+
+        output_size = fsm_decode_packed(fsm, input, blocks[i].bit_count, output);
+        /* The bits are correct, so the codes must be the ones of another probability file. */
+        if (output_size != blocks[i].character_count)
+        {
+            printf("Block %d of \"%s\" does not match the probability file\n", i, encoded_file);
+            exit(EXIT_FAILURE);
+        }
+        if (fwrite(output, 1, output_size, fp_write) != output_size)
+        {
+            printf("Error: Unable to write the output file\n");
+            exit(EXIT_FAILURE);
+        }
+
+        free(input);
+        free(output);
+    }
+    free(blocks);
+    free_fsm_decoder(fsm);
+}
+
+unsigned int block_checksum(unsigned int character_count, unsigned int bit_count,
+                            const unsigned char *bits)
+{
+    unsigned char counts[8];
+
+    write_uint32(counts, character_count);
+    write_uint32(counts + 4, bit_count);
+    return crc32c_update(crc32c(counts, 8), bits, (bit_count + 7) / 8);
+}
+
+unsigned int end_block_checksum(unsigned int end_checksum, unsigned int checksum)
+{
+    unsigned char bytes[4];
+
+    write_uint32(bytes, checksum);
+    return crc32c_update(end_checksum, bytes, 4);
+}
+
+int is_intact_block(BLOCK_INFO *block, const unsigned char *bits)
+{
+    size_t byte_count = (block->bit_count + 7) / 8;
+
+    /* The bits after the last code are always written as 0. */
+    if (block->bit_count % 8 != 0 &&
+        (bits[byte_count - 1] & (0xFF >> (block->bit_count % 8))) != 0)
+    {
+        return 0;
+    }
+    return block_checksum(block->character_count, block->bit_count, bits) == block->checksum;
+}
+
+void write_code_lengths(unsigned char *code_lengths, FILE *fp_write)
+{
+    unsigned char checksum[CODE_LENGTHS_CHECKSUM_SIZE];
+
+    write_uint32(checksum, crc32c(code_lengths, CODE_LENGTHS_SIZE));
+    if (fwrite(code_lengths, 1, CODE_LENGTHS_SIZE, fp_write) != CODE_LENGTHS_SIZE ||
+        fwrite(checksum, 1, CODE_LENGTHS_CHECKSUM_SIZE, fp_write) != CODE_LENGTHS_CHECKSUM_SIZE)
+    {
+        printf("Error: Unable to write the output file\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+int read_code_lengths(unsigned char *code_lengths, FILE *fp_read)
+{
+    unsigned char checksum[CODE_LENGTHS_CHECKSUM_SIZE];
+
+    if (fread(code_lengths, 1, CODE_LENGTHS_SIZE, fp_read) != CODE_LENGTHS_SIZE ||
+        fread(checksum, 1, CODE_LENGTHS_CHECKSUM_SIZE, fp_read) != CODE_LENGTHS_CHECKSUM_SIZE)
+    {
+        return 0;
+    }
+    return crc32c(code_lengths, CODE_LENGTHS_SIZE) == read_uint32(checksum);
+}
+
+int is_container(char *encoded_file)
+{
+    char magic[4];
+    int result = 0;
+    FILE *fp = NULL;
+
+    if ((fp = fopen(encoded_file, "rb")) == NULL)
+    {
+        return 0;
+    }
+    result = (fread(magic, 1, 4, fp) == 4 && memcmp(magic, CONTAINER_MAGIC, 4) == 0);
+    fclose(fp);
+    return result;
+}
+
+void verify_container(char *encoded_file, int thread_count)
+{
+    int i = 0;
+    char magic[4];
+    VERIFY_JOB job;
+    pthread_t *workers = NULL;
+    FILE *fp = NULL;
+
+    if ((fp = fopen(encoded_file, "rb")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+    if (fread(magic, 1, 4, fp) != 4 ||
+        (memcmp(magic, CONTAINER_MAGIC, 4) != 0 && memcmp(magic, COMPRESSED_MAGIC, 4) != 0))
+    {
+        printf("\"%s\" is not a container file\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+    /* The code lengths of a self-contained file have their own checksum. */
+    if (memcmp(magic, COMPRESSED_MAGIC, 4) == 0)
+    {
+        unsigned char code_lengths[CODE_LENGTHS_SIZE];
+
+        if (read_code_lengths(code_lengths, fp) == 0)
+        {
+            printf("The code lengths of \"%s\" are corrupted\n", encoded_file);
+            exit(EXIT_FAILURE);
+        }
+    }
+    job.blocks = read_block_index(fp, &job.block_count);
+    fclose(fp);
+
+    job.encoded_file = encoded_file;
+    job.next_block = 0;
+    job.corrupted_blocks = 0;
+    pthread_mutex_init(&job.lock, NULL);
+
+    /* The tables are built before the workers use them. */
+    init_crc32c();
+
+    if (thread_count <= 0)
+    {
+        thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (thread_count > job.block_count)
+    {
+        thread_count = job.block_count;
+    }
+    if (thread_count < 1)
+    {
+        thread_count = 1;
+    }
+
+    workers = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    if (workers == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < thread_count; i++)
+    {
+        if (pthread_create(&workers[i], NULL, verify_worker, &job) != 0)
+        {
+            printf("Error: Could not create worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (i = 0; i < thread_count; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+    pthread_mutex_destroy(&job.lock);
+    free(workers);
+    free(job.blocks);
+
+    if (job.corrupted_blocks > 0)
+    {
+        printf("\"%s\" has %d corrupted blocks\n", encoded_file, job.corrupted_blocks);
+        exit(EXIT_FAILURE);
+    }
+    printf("\"%s\" is intact. %d blocks checked\n", encoded_file, job.block_count);
+}
+
+BLOCK_INFO *read_block_index(FILE *fp, int *block_count)
+{
+    int capacity = 16;
+    long file_size = 0, position = 0;
+    unsigned int end_checksum = block_checksum(0, 0, NULL);
+    unsigned char header[BLOCK_HEADER_SIZE];
+    BLOCK_INFO *blocks = (BLOCK_INFO *)malloc(capacity * sizeof(BLOCK_INFO));
+
+    if (blocks == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    position = ftell(fp);
+    fseek(fp, 0, SEEK_END);
+    file_size = ftell(fp);
+    fseek(fp, position, SEEK_SET);
+
+    *block_count = 0;
+    while (1)
+    {
+        BLOCK_INFO block;
+
+        if (fread(header, 1, BLOCK_HEADER_SIZE, fp) != BLOCK_HEADER_SIZE)
+        {
+            printf("Error: The container file is truncated\n");
+            exit(EXIT_FAILURE);
+        }
+        block.character_count = read_uint32(header);
+        block.bit_count = read_uint32(header + 4);
+        block.checksum = read_uint32(header + 8);
+        block.offset = ftell(fp);
+
+        /* The empty block ends the file. Its checksum tells it from a corrupted header. */
+        if (block.character_count == 0 && block.bit_count == 0)
+        {
+            if (block.checksum != end_checksum)
+            {
+                printf("Error: Block %d of the container file is corrupted\n", *block_count);
+                exit(EXIT_FAILURE);
+            }
+            if (block.offset != file_size)
+            {
+                printf("Error: The container file has data after its last block\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+
+        /* Every code has at least 1 bit and at most MAX_ASCII - 1 bits. */
+        if (block.character_count > CONTAINER_BLOCK_SIZE ||
+            block.bit_count < block.character_count ||
+            block.bit_count > (unsigned long long)block.character_count * (MAX_ASCII - 1))
+        {
+            printf("Error: Block %d of the container file has %u bits for %u characters\n",
+                   *block_count, block.bit_count, block.character_count);
+            exit(EXIT_FAILURE);
+        }
+
+        if (block.offset + (long)((block.bit_count + 7) / 8) > file_size)
+        {
+            printf("Error: The container file is truncated\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (*block_count == capacity)
+        {
+            capacity *= 2;
+            blocks = (BLOCK_INFO *)realloc(blocks, capacity * sizeof(BLOCK_INFO));
+            if (blocks == NULL)
+            {
+                printf("Error: Unable to Allocate Memory using realloc\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        blocks[(*block_count)++] = block;
+        end_checksum = end_block_checksum(end_checksum, block.checksum);
+        fseek(fp, block.offset + (long)((block.bit_count + 7) / 8), SEEK_SET);
+    }
+    return blocks;
+}
+
+void *verify_worker(void *job)
+{
+    VERIFY_JOB *verify = (VERIFY_JOB *)job;
+    unsigned char *input = NULL;
+    size_t capacity = 0;
+    FILE *fp = NULL;
+
+    /* Each worker reads the file through its own stream. */
+    if ((fp = fopen(verify->encoded_file, "rb")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", verify->encoded_file);
+        exit(EXIT_FAILURE);
+    }
+
+    while (1)
+    {
+        int index = 0;
+        size_t byte_count = 0;
+
+        /* Takes the next block that no other worker has taken. */
+        pthread_mutex_lock(&verify->lock);
+        index = verify->next_block++;
+        pthread_mutex_unlock(&verify->lock);
+
+        if (index >= verify->block_count)
+        {
+            break;
+        }
+
+        byte_count = (verify->blocks[index].bit_count + 7) / 8;
+        if (byte_count > capacity)
+        {
+            capacity = byte_count;
+            input = (unsigned char *)realloc(input, capacity);
+            if (input == NULL)
+            {
+                printf("Error: Unable to Allocate Memory using realloc\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        fseek(fp, verify->blocks[index].offset, SEEK_SET);
+        if (fread(input, 1, byte_count, fp) != byte_count ||
+            is_intact_block(&verify->blocks[index], input) == 0)
+        {
+            printf("Block %d of \"%s\" is corrupted\n", index, verify->encoded_file);
+            pthread_mutex_lock(&verify->lock);
+            verify->corrupted_blocks++;
+            pthread_mutex_unlock(&verify->lock);
+        }
+    }
+    fclose(fp);
+    free(input);
+    return NULL;
+}
+
+void write_uint32(unsigned char *bytes, unsigned int value)
+{
+    bytes[0] = (unsigned char)(value & 0xFF);
+    bytes[1] = (unsigned char)((value >> 8) & 0xFF);
+    bytes[2] = (unsigned char)((value >> 16) & 0xFF);
+    bytes[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+unsigned int read_uint32(unsigned char *bytes)
+{
+    return (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8) |
+           ((unsigned int)bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+}
+
+#ifdef TEST_K
+int main(int argc, char **argv)
+{
+    char *prob_file = argv[1];
+    char *data_file = argv[2];
+    char *encoded_file = argv[3];
+    char *decoded_file = argv[4];
+
+    NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+    char **huffman_table = generate_huffman_table(huffman_tree_root);
+    encode_container(huffman_table, data_file, encoded_file);
+    verify_container(encoded_file, 0);
+    decode_container(huffman_tree_root, encoded_file, decoded_file);
+    free_huffman_tree(huffman_tree_root);
+    free_huffman_table(huffman_table);
+    return 0;
+}
+#endif
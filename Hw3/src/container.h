@@ -0,0 +1,221 @@
+#ifndef CONTAINER
+#define CONTAINER
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "huffman_tree.h"
+#include "encoder.h"
+#include "decoder.h"
+#include "crc32c.h"
+#include "fsm_decoder.h"
+
+/** @brief The first bytes of a container file. */
+#define CONTAINER_MAGIC "HUFB"
+
+/** @brief The first bytes of a self-contained file.
+ *
+ *  A self-contained file is COMPRESSED_MAGIC followed by the length of the code of each
+ *  character, one byte each, the CRC32C of the lengths as a 32-bit little-endian number and
+ *  then the same blocks as a container file.
+ */
+#define COMPRESSED_MAGIC "HUFX"
+
+/** @brief Size of the code lengths after COMPRESSED_MAGIC, one byte per character. */
+#define CODE_LENGTHS_SIZE 128
+
+/** @brief Size of the CRC32C of the code lengths, after them. */
+#define CODE_LENGTHS_CHECKSUM_SIZE 4
+
+/** @brief Number of characters of the data file encoded in each block. */
+#define CONTAINER_BLOCK_SIZE 65536
+
+/** @brief Size of the header before each block: characters, bits and checksum. */
+#define BLOCK_HEADER_SIZE 12
+
+/** @brief Where a block is in a container file and what its header says.
+ *
+ *  A container file is CONTAINER_MAGIC followed by blocks. Each block is a header of three
+ *  32-bit little-endian numbers, the number of characters, the number of bits and the CRC32C
+ *  of the first two numbers and the bits, followed by the bits packed in bytes. A block with
+ *  no characters and no bits ends the file, and its checksum is end_block_checksum() of the
+ *  checksums of all the blocks before it. Nothing follows it. Every block starts at the root
+ *  of the Huffman binary tree, so each block can be checked or decoded on its own.
+ */
+typedef struct {
+    long offset;                  /* Where the bits of the block start in the file. */
+    unsigned int character_count; /* Number of characters the block decodes to. */
+    unsigned int bit_count;       /* Number of bits in the block. */
+    unsigned int checksum;        /* CRC32C of the counts and the bytes of the block. */
+} BLOCK_INFO;
+
+/** @brief The blocks of a container file and the progress of the workers checking them.
+ *
+ *  Workers take the next block to check from next_block, which is protected by lock.
+ */
+typedef struct {
+    char *encoded_file;   /* The container file. Each worker opens it on its own. */
+    BLOCK_INFO *blocks;   /* The blocks of the file. */
+    int block_count;      /* Number of blocks. */
+    int next_block;       /* Index of the next block a worker will take. */
+    int corrupted_blocks; /* Number of blocks whose checksum does not match. */
+    pthread_mutex_t lock;
+} VERIFY_JOB;
+
+/** @brief Encodes a data file using the Huffman codes into a container file.
+ *
+ *   The codes are saved as packed bits, in blocks with a CRC32C checksum each.
+ *
+ *   @param huffman_table the Huffman table to get the Huffman codes
+ *   @param data_file     the file to get the data to encode
+ *   @param encoded_file  the file name of the container file to save the encoded data in
+ *   @return void
+ */
+void encode_container(char **huffman_table, char *data_file, char *encoded_file);
+
+/** @brief Decodes a container file by traversing the Huffman binary tree.
+ *
+ *   The checksum of each block is checked before it is decoded. The program is
+ *   terminated at the first corrupted block.
+ *
+ *   @param huffman_tree_root the root of the Huffman binary tree
+ *   @param encoded_file      the container file to decode
+ *   @param decoded_file      the file name of the output file to save the decoded data in
+ *   @return void
+ */
+void decode_container(NODE *huffman_tree_root, char *encoded_file, char *decoded_file);
+
+/** @brief Encodes a block of data into a container file, with its header.
+ *
+ *   The program is terminated if the data has characters outside the Huffman table or if
+ *   the block cannot be written.
+ *
+ *   @param bit_codes    the code of each character as bits
+ *   @param pair_codes   the combined code of each pair of characters, or NULL
+ *   @param input        the data to encode
+ *   @param input_size   the number of characters in input, 0 for the block that ends the file
+ *   @param output       the array to pack the bits in, as for encode_block_packed()
+ *   @param end_checksum the checksum of the block that ends the file, block_checksum(0, 0,
+ *                       NULL) before the first block. Each block is added to it
+ *   @param fp_write     the container file
+ *   @return void
+ */
+void write_container_block(BIT_CODE *bit_codes, PAIR_CODE *pair_codes, char *input,
+                           size_t input_size, unsigned char *output, unsigned int *end_checksum,
+                           FILE *fp_write);
+
+/** @brief Decodes all the blocks of a container file.
+ *
+ *   The file needs to be positioned at the first block. The checksum of each block is
+ *   checked before it is decoded and the program is terminated at the first corrupted block.
+ *
+ *   @param huffman_tree_root the root of the Huffman binary tree
+ *   @param fp_read           the container file
+ *   @param encoded_file      the name of the container file, for the error messages
+ *   @param fp_write          the file to save the decoded data in
+ *   @return void
+ */
+void decode_container_blocks(NODE *huffman_tree_root, FILE *fp_read, char *encoded_file,
+                             FILE *fp_write);
+
+/** @brief Computes the checksum of a block, which covers its counts and its bits.
+ *
+ *   @param character_count the number of characters of the block
+ *   @param bit_count       the number of bits of the block
+ *   @param bits            the bits of the block, packed in (bit_count + 7) / 8 bytes
+ *   @return the CRC32C of the first 8 bytes of the header followed by the bits
+ */
+unsigned int block_checksum(unsigned int character_count, unsigned int bit_count,
+                            const unsigned char *bits);
+
+/** @brief Adds the checksum of a block to the checksum of the block that ends the file.
+ *
+ *   @param end_checksum the checksum of the blocks before, or block_checksum(0, 0, NULL)
+ *   @param checksum     the checksum of the block
+ *   @return the CRC32C of the checksums of the blocks as 32-bit little-endian numbers,
+ *           continued from the one of an empty block
+ */
+unsigned int end_block_checksum(unsigned int end_checksum, unsigned int checksum);
+
+/** @brief Checks the bits of a block against its header.
+ *
+ *   @param block the header of the block
+ *   @param bits  the bits of the block, packed in (bit_count + 7) / 8 bytes
+ *   @return 1 if the checksum matches and the padding bits of the last byte are 0, or 0
+ */
+int is_intact_block(BLOCK_INFO *block, const unsigned char *bits);
+
+/** @brief Saves the code lengths of a self-contained file, followed by their checksum.
+ *
+ *   The program is terminated if they cannot be written.
+ *
+ *   @param code_lengths the length of the code of each character
+ *   @param fp_write     the self-contained file, positioned after COMPRESSED_MAGIC
+ *   @return void
+ */
+void write_code_lengths(unsigned char *code_lengths, FILE *fp_write);
+
+/** @brief Reads the code lengths of a self-contained file and checks their checksum.
+ *
+ *   @param code_lengths the array to save the length of the code of each character in
+ *   @param fp_read      the self-contained file, positioned after COMPRESSED_MAGIC
+ *   @return 1 if the lengths were read and match their checksum, or 0 otherwise
+ */
+int read_code_lengths(unsigned char *code_lengths, FILE *fp_read);
+
+/** @brief Checks whether a file is a container file.
+ *
+ *   @param encoded_file the file to check
+ *   @return 1 if the file starts with CONTAINER_MAGIC or 0 otherwise
+ */
+int is_container(char *encoded_file);
+
+/** @brief Checks the checksums of all the blocks of a container file without decoding it.
+ *
+ *   Self-contained files are checked the same way.
+ *
+ *   The blocks are shared between worker threads. Every corrupted block is reported and
+ *   the program is terminated with a failure status if there is any.
+ *
+ *   @param encoded_file the container file to check
+ *   @param thread_count the number of worker threads, or 0 to use one per processor
+ *   @return void
+ */
+void verify_container(char *encoded_file, int thread_count);
+
+/** @brief Reads the headers of all the blocks of a container file.
+ *
+ *   The file needs to be positioned at the first block. The bits of the blocks are skipped.
+ *   The program is terminated if the file is truncated, if the number of bits of a block
+ *   cannot be the one of its number of characters, if the checksum of the block that ends the
+ *   file does not match the blocks before it or if there is anything after that block.
+ *
+ *   @param fp          the container file
+ *   @param block_count the number of blocks found
+ *   @return the blocks of the file
+ */
+BLOCK_INFO *read_block_index(FILE *fp, int *block_count);
+
+/** @brief Worker thread of verify_container().
+ *
+ *   @param job the VERIFY_JOB shared by all the workers
+ *   @return NULL
+ */
+void *verify_worker(void *job);
+
+/** @brief Saves a number as 4 little-endian bytes.
+ *
+ *   @param bytes the array to save the number in
+ *   @param value the number
+ *   @return void
+ */
+void write_uint32(unsigned char *bytes, unsigned int value);
+
+/** @brief Reads a number saved as 4 little-endian bytes.
+ *
+ *   @param bytes the array to read the number from
+ *   @return the number
+ */
+unsigned int read_uint32(unsigned char *bytes);
+
+#endif
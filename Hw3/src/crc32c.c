@@ -0,0 +1,89 @@
+#include "crc32c.h"
+
+/* Reversed Castagnoli polynomial. */
+#define CRC32C_POLYNOMIAL 0x82F63B78u
+
+/*
+ * crc_tables[0] is the usual byte-at-a-time table. crc_tables[k] gives the CRC of a byte
+ * followed by k zero bytes, so 8 bytes can be combined with 8 independent lookups.
+ */
+static unsigned int crc_tables[8][256];
+static int crc_tables_ready = 0;
+
+void init_crc32c(void)
+{
+    unsigned int i = 0, k = 0;
+
+    if (crc_tables_ready == 1)
+    {
+        return;
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        unsigned int crc = i;
+
+        for (k = 0; k < 8; k++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+        }
+        crc_tables[0][i] = crc;
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        for (k = 1; k < 8; k++)
+        {
+            crc_tables[k][i] = (crc_tables[k - 1][i] >> 8) ^
+                               crc_tables[0][crc_tables[k - 1][i] & 0xFF];
+        }
+    }
+    crc_tables_ready = 1;
+}
+
+unsigned int crc32c(const unsigned char *data, size_t size)
+{
+    return crc32c_update(0, data, size);
+}
+
+unsigned int crc32c_update(unsigned int crc, const unsigned char *data, size_t size)
+{
+    /* The final inversion of the previous checksum is undone. */
+    crc ^= 0xFFFFFFFFu;
+
+    init_crc32c();
+
+    /* Eight bytes per step. The bytes are combined in little-endian order on any machine. */
+    while (size >= 8)
+    {
+        unsigned int low = crc ^ ((unsigned int)data[0] | ((unsigned int)data[1] << 8) |
+                                  ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24));
+
+        crc = crc_tables[7][low & 0xFF] ^ crc_tables[6][(low >> 8) & 0xFF] ^
+              crc_tables[5][(low >> 16) & 0xFF] ^ crc_tables[4][low >> 24] ^
+              crc_tables[3][data[4]] ^ crc_tables[2][data[5]] ^
+              crc_tables[1][data[6]] ^ crc_tables[0][data[7]];
+        data += 8;
+        size -= 8;
+    }
+
+    /* The remaining bytes, one at a time. */
+    while (size > 0)
+    {
+        crc = (crc >> 8) ^ crc_tables[0][(crc ^ *data) & 0xFF];
+        data++;
+        size--;
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+#ifdef TEST_C
+int main(int argc, char **argv)
+{
+    /* The standard check value of CRC32C is E3069283. */
+    const unsigned char check[] = "123456789";
+
+    printf("%08X\n", crc32c(check, 9));
+    return 0;
+}
+#endif
@@ -0,0 +1,37 @@
+#ifndef CRC32C
+#define CRC32C
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/** @brief Computes the CRC32C (Castagnoli) checksum of a block of data.
+ *
+ *   Uses the slicing-by-8 method, which processes 8 bytes per step with 8 lookup tables.
+ *   The tables are built on the first call. The first call must not race with other threads,
+ *   so programs that use threads call init_crc32c() first.
+ *
+ *   @param data the data to checksum
+ *   @param size the number of bytes in data
+ *   @return the checksum
+ */
+unsigned int crc32c(const unsigned char *data, size_t size);
+
+/** @brief Continues a CRC32C checksum with more data.
+ *
+ *   crc32c_update(crc32c(a, m), b, n) is the checksum of a followed by b, so data in
+ *   separate arrays can be checked as one.
+ *
+ *   @param crc  the checksum of the data before, or 0 for none
+ *   @param data the data to add to the checksum
+ *   @param size the number of bytes in data
+ *   @return the checksum
+ */
+unsigned int crc32c_update(unsigned int crc, const unsigned char *data, size_t size);
+
+/** @brief Builds the lookup tables of crc32c().
+ *
+ *   @return void
+ */
+void init_crc32c(void);
+
+#endif
@@ -2,8 +2,6 @@
 
 void encode(char **huffman_table, char *data_file, char *encoded_file)
 {
-    char character = 0;
-    int ascii_value = 0;
     FILE *fp_read = NULL, *fp_write = NULL;
 
     if ((fp_read = fopen(data_file, "r")) == NULL)
@@ -18,18 +16,234 @@ void encode(char **huffman_table, char *data_file, char *encoded_file)
         exit(EXIT_FAILURE);
     }
 
-    /* 
-    * Encode each character in the data file using the Huffman codes and write it in the 
-    * the output file.
-    */
-    while ((character = fgetc(fp_read)) != EOF)
+    switch (encode_stream(huffman_table, fp_read, fp_write))
     {
-        ascii_value = (int) character;
-        fprintf(fp_write, "%s", huffman_table[ascii_value]);
-    }   
-    printf("Encoding done. Result in: \"%s\"\n", encoded_file);
+    case -1:
+        printf("File cannot have ASCII characters with value above 127\n");
+        exit(EXIT_FAILURE);
+    case -2:
+        printf("Error: Unable to read or write the files\n");
+        exit(EXIT_FAILURE);
+    }
     fclose(fp_read);
-    fclose(fp_write); 
+    if (fclose(fp_write) != 0)
+    {
+        printf("Error: Unable to write the output file\n");
+        exit(EXIT_FAILURE);
+    }
+    printf("Encoding done. Result in: \"%s\"\n", encoded_file);
+}
+
+int encode_stream(char **huffman_table, FILE *fp_read, FILE *fp_write)
+{
+    int i = 0;
+    int result = 0;
+    int max_length = 0; /* Length of the longest Huffman code. */
+    int *code_lengths = (int *)malloc(MAX_ASCII * sizeof(int));
+    char *input = (char *)malloc(STREAM_BLOCK_SIZE);
+    char *output = NULL;
+    size_t read_count = 0;
+
+    if (code_lengths == NULL || input == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        code_lengths[i] = strlen(huffman_table[i]);
+        if (code_lengths[i] > max_length)
+        {
+            max_length = code_lengths[i];
+        }
+    }
+    output = (char *)malloc((size_t)STREAM_BLOCK_SIZE * max_length);
+    if (output == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The file is encoded a block at a time, like the blocks of encode_pipelined(). */
+    while (result == 0 && (read_count = fread(input, 1, STREAM_BLOCK_SIZE, fp_read)) > 0)
+    {
+        long output_size = encode_block(huffman_table, code_lengths, input, read_count, output);
+
+        if (output_size < 0)
+        {
+            result = -1;
+        }
+        else if (fwrite(output, 1, (size_t)output_size, fp_write) != (size_t)output_size)
+        {
+            result = -2;
+        }
+    }
+    if (result == 0 && ferror(fp_read))
+    {
+        result = -2;
+    }
+
+    free(code_lengths);
+    free(input);
+    free(output);
+    return result;
+}
+
+long encode_block(char **huffman_table, int *code_lengths, char *input, size_t input_size,
+                  char *output)
+{
+    size_t i = 0;
+    char *next = output; /* Where the next code is copied. */
+
+    for (i = 0; i < input_size; i++)
+    {
+        int character = (unsigned char)input[i];
+
+        /* Characters outside the Huffman table cannot be encoded. */
+        if (character >= MAX_ASCII)
+        {
+            return -1;
+        }
+        memcpy(next, huffman_table[character], code_lengths[character]);
+        next += code_lengths[character];
+    }
+    return (long)(next - output);
+}
+
+BIT_CODE *generate_bit_codes(char **huffman_table)
+{
+    int i = 0, j = 0;
+    BIT_CODE *bit_codes = (BIT_CODE *)malloc(MAX_ASCII * sizeof(BIT_CODE));
+
+    if (bit_codes == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        BIT_CODE *code = &bit_codes[i];
+
+        code->length = strlen(huffman_table[i]);
+        code->chunk_count = 0;
+        for (j = 0; j < 4; j++)
+        {
+            code->chunks[j] = 0;
+            code->chunk_lengths[j] = 0;
+        }
+
+        /* Every 32 characters of the code start a new chunk. */
+        for (j = 0; j < code->length; j++)
+        {
+            int chunk = j / 32;
+
+            code->chunks[chunk] = (code->chunks[chunk] << 1) | (huffman_table[i][j] == '1');
+            code->chunk_lengths[chunk]++;
+            code->chunk_count = chunk + 1;
+        }
+    }
+    return bit_codes;
+}
+
+PAIR_CODE *generate_pair_codes(BIT_CODE *bit_codes)
+{
+    int first = 0, second = 0;
+    PAIR_CODE *pair_codes = (PAIR_CODE *)malloc(MAX_ASCII * MAX_ASCII * sizeof(PAIR_CODE));
+
+    if (pair_codes == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (first = 0; first < MAX_ASCII; first++)
+    {
+        for (second = 0; second < MAX_ASCII; second++)
+        {
+            PAIR_CODE *pair = &pair_codes[first * MAX_ASCII + second];
+            int length = bit_codes[first].length + bit_codes[second].length;
+
+            pair->bits = 0;
+            pair->length = 0;
+            /* Codes of up to PAIR_CODE_BITS bits have a single chunk. */
+            if (length <= PAIR_CODE_BITS)
+            {
+                pair->bits = (bit_codes[first].chunks[0] << bit_codes[second].length) |
+                             bit_codes[second].chunks[0];
+                pair->length = length;
+            }
+        }
+    }
+    return pair_codes;
+}
+
+long encode_block_packed(BIT_CODE *bit_codes, PAIR_CODE *pair_codes, char *input,
+                         size_t input_size, unsigned char *output)
+{
+    size_t i = 0;
+    int j = 0;
+    long bit_count = 0;
+    /* Bits that do not fill a whole byte yet. At most 7 + 32 bits are ever buffered. */
+    unsigned long long buffer = 0;
+    int buffered = 0;
+
+    while (i < input_size)
+    {
+        int character = (unsigned char)input[i];
+        BIT_CODE *code = NULL;
+
+        /* Characters outside the Huffman table cannot be encoded. */
+        if (character >= MAX_ASCII)
+        {
+            return -1;
+        }
+
+        /* Two characters at once, if their combined code fits in a PAIR_CODE. */
+        if (pair_codes != NULL && i + 1 < input_size &&
+            (unsigned char)input[i + 1] < MAX_ASCII)
+        {
+            PAIR_CODE *pair = &pair_codes[character * MAX_ASCII + (unsigned char)input[i + 1]];
+
+            if (pair->length > 0)
+            {
+                buffer = (buffer << pair->length) | pair->bits;
+                buffered += pair->length;
+                while (buffered >= 8)
+                {
+                    buffered -= 8;
+                    *output++ = (unsigned char)(buffer >> buffered);
+                }
+                bit_count += pair->length;
+                i += 2;
+                continue;
+            }
+        }
+
+        code = &bit_codes[character];
+
+        for (j = 0; j < code->chunk_count; j++)
+        {
+            buffer = (buffer << code->chunk_lengths[j]) | code->chunks[j];
+            buffered += code->chunk_lengths[j];
+
+            /* Saves every complete byte. */
+            while (buffered >= 8)
+            {
+                buffered -= 8;
+                *output++ = (unsigned char)(buffer >> buffered);
+            }
+        }
+        bit_count += code->length;
+        i++;
+    }
+
+    /* The last bits are padded with 0 bits to a whole byte. */
+    if (buffered > 0)
+    {
+        *output = (unsigned char)(buffer << (8 - buffered));
+    }
+    return bit_count;
 }
 
 #ifdef TEST_E
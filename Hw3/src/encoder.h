@@ -5,6 +5,35 @@
 #include <stdlib.h>
 #include "huffman_tree.h"
 
+/** @brief A Huffman code as bits instead of '0' and '1' characters.
+ *
+ *  The code is split in chunks of up to 32 bits, so codes of any length up to MAX_ASCII - 1
+ *  bits fit. The first chunk holds the first bits of the code.
+ */
+typedef struct {
+    unsigned int chunks[4]; /* The bits of the code, 32 per chunk except for the last chunk. */
+    int chunk_lengths[4];   /* The number of bits in each chunk. */
+    int chunk_count;        /* The number of chunks used. */
+    int length;             /* The total number of bits of the code. */
+} BIT_CODE;
+
+/** @brief Number of characters encode_stream() reads and encodes at a time. */
+#define STREAM_BLOCK_SIZE 65536
+
+/** @brief Longest combined code of two characters that is saved in a PAIR_CODE. */
+#define PAIR_CODE_BITS 32
+
+/** @brief The codes of two characters one after the other, as bits.
+ *
+ *  There is one for every pair of characters, 16K in total, found at index
+ *  first * MAX_ASCII + second. Pairs whose combined code is longer than PAIR_CODE_BITS
+ *  have a length of 0 and are encoded a character at a time.
+ */
+typedef struct {
+    unsigned int bits; /* The code of the first character followed by the code of the second. */
+    int length;        /* The number of bits, or 0 if the pair is not combined. */
+} PAIR_CODE;
+
 /** @brief Encodes a data file using the Huffman codes.
  *  
  *   Saves the resulting encoded data in an output file.
@@ -18,4 +47,71 @@
  */
 void encode(char **huffman_table, char *data_file, char *encoded_file);
 
+/** @brief Encodes the data of an open file using the Huffman codes.
+ *
+ *   Used by encode() and by the modes that encode many files with one Huffman table.
+ *   The file is read STREAM_BLOCK_SIZE characters at a time, and each block is encoded
+ *   with encode_block() and written with one fwrite().
+ *
+ *   @param huffman_table the Huffman table to get the Huffman codes
+ *   @param fp_read       the file to get the data to encode
+ *   @param fp_write      the file to save the encoded data in
+ *   @return 0 on success, -1 if the data has characters outside the Huffman table or -2 if
+ *           a file cannot be read or written
+ */
+int encode_stream(char **huffman_table, FILE *fp_read, FILE *fp_write);
+
+/** @brief Encodes a block of data in memory using the Huffman codes.
+ *
+ *   output needs room for input_size times the length of the longest code.
+ *
+ *   Unlike encode_block_packed(), it does not use PAIR_CODE: each bit is a whole character
+ *   here, so writing the output costs as much as looking up the codes and combined codes
+ *   encode no faster.
+ *
+ *   @param huffman_table the Huffman table to get the Huffman codes
+ *   @param code_lengths  the length of each Huffman code
+ *   @param input         the data to encode
+ *   @param input_size    the number of characters in input
+ *   @param output        the array to save the encoded data in
+ *   @return the number of characters saved in output, or -1 if the data has characters
+ *           outside the Huffman table
+ */
+long encode_block(char **huffman_table, int *code_lengths, char *input, size_t input_size,
+                  char *output);
+
+/** @brief Converts the codes of the Huffman table to bits.
+ *
+ *   @param huffman_table the Huffman table to get the Huffman codes
+ *   @return the code of each character as bits
+ */
+BIT_CODE *generate_bit_codes(char **huffman_table);
+
+/** @brief Combines the codes of every pair of characters.
+ *
+ *   @param bit_codes the code of each character as bits
+ *   @return the PAIR_CODE of each pair of characters
+ */
+PAIR_CODE *generate_pair_codes(BIT_CODE *bit_codes);
+
+/** @brief Encodes a block of data in memory as packed bits.
+ *
+ *   Eight bits are saved in each byte, the first bit in the highest bit of the byte.
+ *   The last byte is padded with 0 bits. output needs room for input_size times the length
+ *   of the longest code, divided by 8, plus one byte.
+ *
+ *   When pair_codes is given, two characters are encoded with each lookup wherever their
+ *   combined code is short enough. The result is the same either way.
+ *
+ *   @param bit_codes  the code of each character as bits
+ *   @param pair_codes the combined code of each pair of characters, or NULL
+ *   @param input      the data to encode
+ *   @param input_size the number of characters in input
+ *   @param output     the array to save the encoded bits in
+ *   @return the number of bits saved in output, or -1 if the data has characters
+ *           outside the Huffman table
+ */
+long encode_block_packed(BIT_CODE *bit_codes, PAIR_CODE *pair_codes, char *input,
+                         size_t input_size, unsigned char *output);
+
 #endif
\ No newline at end of file
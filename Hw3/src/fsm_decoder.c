@@ -0,0 +1,242 @@
+#include "fsm_decoder.h"
+
+FSM *build_fsm_decoder(NODE *huffman_tree_root)
+{
+    int i = 0, j = 0, bit = 0;
+    NODE **nodes = NULL;
+    FSM *fsm = (FSM *)malloc(sizeof(FSM));
+
+    nodes = (NODE **)malloc(MAX_ASCII * sizeof(NODE *));
+    if (fsm == NULL || nodes == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    fsm->state_count = 0;
+    number_internal_nodes(huffman_tree_root, nodes, &fsm->state_count);
+
+    fsm->children = malloc(fsm->state_count * sizeof(*fsm->children));
+    fsm->table = (FSM_ENTRY *)malloc(fsm->state_count * 256 * sizeof(FSM_ENTRY));
+    if (fsm->children == NULL || fsm->table == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* The children of each internal node, as in the decode table of emit_c_codebook(). */
+    for (i = 0; i < fsm->state_count; i++)
+    {
+        NODE *child[2];
+
+        child[0] = nodes[i]->left;
+        child[1] = nodes[i]->right;
+        for (bit = 0; bit < 2; bit++)
+        {
+            if (child[bit]->left == NULL && child[bit]->right == NULL)
+            {
+                fsm->children[i][bit] = -((int)child[bit]->character + 1);
+            }
+            else
+            {
+                fsm->children[i][bit] = find_node_number(nodes, fsm->state_count, child[bit]);
+            }
+        }
+    }
+
+    /* Runs each of the 256 bytes from each internal node through the tree, a bit at a time. */
+    for (i = 0; i < fsm->state_count; i++)
+    {
+        for (j = 0; j < 256; j++)
+        {
+            FSM_ENTRY *entry = &fsm->table[256 * i + j];
+            int state = i;
+
+            entry->symbol_count = 0;
+            for (bit = 7; bit >= 0; bit--)
+            {
+                int character = fsm_step(fsm, &state, (j >> bit) & 1);
+
+                if (character >= 0)
+                {
+                    entry->symbols[entry->symbol_count++] = (char)character;
+                }
+            }
+            entry->next_state = (unsigned char)state;
+        }
+    }
+
+    free(nodes);
+    return fsm;
+}
+
+size_t fsm_decode_packed(FSM *fsm, unsigned char *input, unsigned long bit_count,
+                         char *output)
+{
+    unsigned long i = 0;
+    size_t output_size = 0;
+    int state = 0;
+
+    /* Whole bytes, one lookup each. */
+    for (i = 0; i < bit_count / 8; i++)
+    {
+        FSM_ENTRY *entry = &fsm->table[256 * state + input[i]];
+
+        memcpy(output + output_size, entry->symbols, entry->symbol_count);
+        output_size += entry->symbol_count;
+        state = entry->next_state;
+    }
+
+    /* The bits of the last byte, without its padding. */
+    for (i = bit_count & ~7UL; i < bit_count; i++)
+    {
+        int character = fsm_step(fsm, &state, (input[i >> 3] >> (7 - (i & 7))) & 1);
+
+        if (character >= 0)
+        {
+            output[output_size++] = (char)character;
+        }
+    }
+    return output_size;
+}
+
+size_t fsm_decode_text(FSM *fsm, FSM_STATE *state, char *input, size_t input_size,
+                       char *output)
+{
+    size_t i = 0;
+    size_t output_size = 0;
+    int current_state = state->state;
+    unsigned int pending = state->pending;
+    int pending_count = state->pending_count;
+
+    while (i < input_size)
+    {
+        int byte = -1; /* The next 8 bits, once there are 8 of them. */
+        FSM_ENTRY *entry = NULL;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        /*
+         * When no bits are pending, 8 characters are packed at once. Clearing the lowest bit
+         * of '0' and '1' leaves '0', so the test checks that all 8 are bits. The multiplication
+         * moves the lowest bit of character k to bit 7 - k of the top byte.
+         */
+        if (pending_count == 0 && i + 8 <= input_size)
+        {
+            unsigned long long word = 0;
+
+            memcpy(&word, input + i, 8);
+            if ((word & 0xFEFEFEFEFEFEFEFEULL) == 0x3030303030303030ULL)
+            {
+                byte = (int)(((word & 0x0101010101010101ULL) * 0x8040201008040201ULL) >> 56);
+                i += 8;
+            }
+        }
+#endif
+        if (byte < 0)
+        {
+            /* Other characters are ignored, like decode() does. */
+            if (input[i] == '0' || input[i] == '1')
+            {
+                pending = (pending << 1) | (unsigned int)(input[i] - '0');
+                pending_count++;
+            }
+            i++;
+            if (pending_count < 8)
+            {
+                continue;
+            }
+            byte = (int)pending;
+            pending = 0;
+            pending_count = 0;
+        }
+
+        entry = &fsm->table[256 * current_state + byte];
+        memcpy(output + output_size, entry->symbols, entry->symbol_count);
+        output_size += entry->symbol_count;
+        current_state = entry->next_state;
+    }
+
+    state->state = current_state;
+    state->pending = pending;
+    state->pending_count = pending_count;
+    return output_size;
+}
+
+size_t fsm_decode_flush(FSM *fsm, FSM_STATE *state, char *output)
+{
+    size_t output_size = 0;
+
+    /* The pending bits are decoded one at a time, the first bit first. */
+    while (state->pending_count > 0)
+    {
+        int character = 0;
+
+        state->pending_count--;
+        character = fsm_step(fsm, &state->state, (state->pending >> state->pending_count) & 1);
+        if (character >= 0)
+        {
+            output[output_size++] = (char)character;
+        }
+    }
+    state->pending = 0;
+    return output_size;
+}
+
+int fsm_step(FSM *fsm, int *state, int bit)
+{
+    int child = fsm->children[*state][bit];
+
+    /* A leaf decodes its character and the next code starts from the root. */
+    if (child < 0)
+    {
+        *state = 0;
+        return -child - 1;
+    }
+    *state = child;
+    return -1;
+}
+
+void free_fsm_decoder(FSM *fsm)
+{
+    free(fsm->table);
+    free(fsm->children);
+    free(fsm);
+}
+
+#ifdef TEST_F
+int main(int argc, char **argv)
+{
+    char *prob_file = argv[1];
+    char *encoded_file = argv[2];
+    char *input = NULL, *output = NULL;
+    size_t input_size = 0, output_size = 0;
+    FSM_STATE state = {0, 0, 0};
+    FILE *fp = NULL;
+
+    NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+    FSM *fsm = build_fsm_decoder(huffman_tree_root);
+
+    if ((fp = fopen(encoded_file, "r")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+    fseek(fp, 0, SEEK_END);
+    input_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    input = (char *)malloc(input_size + 1);
+    output = (char *)malloc(input_size + 8);
+    input_size = fread(input, 1, input_size, fp);
+    fclose(fp);
+
+    output_size = fsm_decode_text(fsm, &state, input, input_size, output);
+    output_size += fsm_decode_flush(fsm, &state, output + output_size);
+    fwrite(output, 1, output_size, stdout);
+
+    free(input);
+    free(output);
+    free_fsm_decoder(fsm);
+    free_huffman_tree(huffman_tree_root);
+    return 0;
+}
+#endif
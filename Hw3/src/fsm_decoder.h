@@ -0,0 +1,103 @@
+#ifndef FSM_DECODER
+#define FSM_DECODER
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "huffman_tree.h"
+#include "codegen.h"
+
+/** @brief What happens when the decoder reads 8 bits while it is at an internal node.
+ *
+ *  Every code is at least one bit, so 8 bits decode to at most 8 characters.
+ */
+typedef struct {
+    unsigned char next_state;   /* The internal node the decoder is at after the 8 bits. */
+    unsigned char symbol_count; /* The number of characters decoded by the 8 bits. */
+    char symbols[8];            /* The characters decoded by the 8 bits. */
+} FSM_ENTRY;
+
+/** @brief Finite-state machine that decodes a byte at a time.
+ *
+ *  The states are the internal nodes of the Huffman binary tree, numbered by
+ *  number_internal_nodes(), so the root is state 0. Entry 256 * state + byte of the table
+ *  says where the decoder ends up and what it decodes when it reads byte at that state.
+ */
+typedef struct {
+    int state_count;    /* The number of internal nodes. */
+    FSM_ENTRY *table;   /* state_count * 256 entries. */
+    int (*children)[2]; /* Children of each state, -(character + 1) for leaves. */
+} FSM;
+
+/** @brief Where a decoder stopped in a stream of '0' and '1' characters.
+ *
+ *  Up to 7 bits that do not fill a byte yet are kept until the next block.
+ */
+typedef struct {
+    int state;             /* The internal node the decoder is at. */
+    unsigned int pending;  /* Bits that do not fill a byte yet, the first bit highest. */
+    int pending_count;     /* The number of pending bits. */
+} FSM_STATE;
+
+/** @brief Builds the finite-state machine of a Huffman binary tree.
+ *
+ *   @param huffman_tree_root the root of the Huffman binary tree
+ *   @return the finite-state machine
+ */
+FSM *build_fsm_decoder(NODE *huffman_tree_root);
+
+/** @brief Decodes packed bits a byte at a time.
+ *
+ *   The bits are packed as encode_block_packed() saves them. The last bits that do not
+ *   fill a byte are decoded one at a time, so padding bits are never decoded.
+ *
+ *   @param fsm       the finite-state machine of the Huffman binary tree
+ *   @param input     the packed bits to decode
+ *   @param bit_count the number of bits in input
+ *   @param output    the array to save the decoded data in, with room for bit_count characters
+ *   @return the number of characters saved in output
+ */
+size_t fsm_decode_packed(FSM *fsm, unsigned char *input, unsigned long bit_count,
+                         char *output);
+
+/** @brief Decodes a block of '0' and '1' characters a byte at a time.
+ *
+ *   Every 8 bits are packed in a byte and decoded with one lookup. Other characters are
+ *   ignored, like decode() does. The bits that do not fill a byte are kept in state for
+ *   the next block and decoded by fsm_decode_flush() at the end of the data.
+ *
+ *   @param fsm        the finite-state machine of the Huffman binary tree
+ *   @param state      where the decoder is, updated to where the block ends
+ *   @param input      the encoded data to decode
+ *   @param input_size the number of characters in input
+ *   @param output     the array to save the decoded data in, with room for input_size characters
+ *   @return the number of characters saved in output
+ */
+size_t fsm_decode_text(FSM *fsm, FSM_STATE *state, char *input, size_t input_size,
+                       char *output);
+
+/** @brief Decodes the bits that fsm_decode_text() kept at the end of the data.
+ *
+ *   @param fsm    the finite-state machine of the Huffman binary tree
+ *   @param state  where the decoder is
+ *   @param output the array to save the decoded data in, with room for 7 characters
+ *   @return the number of characters saved in output
+ */
+size_t fsm_decode_flush(FSM *fsm, FSM_STATE *state, char *output);
+
+/** @brief Moves the decoder by a single bit.
+ *
+ *   @param fsm   the finite-state machine of the Huffman binary tree
+ *   @param state the internal node the decoder is at, updated to the next one
+ *   @param bit   the bit to read
+ *   @return the decoded character if the bit ends a code, or -1 otherwise
+ */
+int fsm_step(FSM *fsm, int *state, int bit);
+
+/** @brief Frees up the finite-state machine from memory.
+ *
+ *   @param fsm the finite-state machine
+ *   @return void
+ */
+void free_fsm_decoder(FSM *fsm);
+
+#endif
@@ -1,9 +1,17 @@
 #include "huffman_tree.h"
 
 NODE *generate_huffman_tree(char *prob_file)
+{
+    float *prob_table = get_prob_table(prob_file);
+    NODE *huffman_binary_tree = build_huffman_tree(prob_table);
+
+    free(prob_table);
+    return huffman_binary_tree;
+}
+
+NODE *build_huffman_tree(float *prob_table)
 {
     int i = 0;
-    float *prob_table = NULL;         /* Probability table to fill with prob_file values. */
     NODE **character_trees = NULL;    /* Trees that correspond to each character, as a root. */
     NODE* huffman_binary_tree = NULL; /* The root node to return. */
     /* 
@@ -13,7 +21,6 @@ NODE *generate_huffman_tree(char *prob_file)
     int lowestIndex1 = -1, lowestIndex2 = -1;
     int trees_remaining = MAX_ASCII;
 
-    prob_table = get_prob_table(prob_file);    
     /*
      * Allocates memory to an array that holds 128 pointers of type NODE.
      * Before building the huffman tree, each character is a tree on its own.
@@ -39,7 +46,6 @@ NODE *generate_huffman_tree(char *prob_file)
         character_trees[i]->left = NULL;
         character_trees[i]->right = NULL;       
     }  
-    free(prob_table);
     
     /* The final tree is the Huffman binary tree. */
     while (trees_remaining > 1)
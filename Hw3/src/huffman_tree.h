@@ -25,6 +25,13 @@ typedef struct node {
  */
 NODE *generate_huffman_tree(char *prob_file);
 
+/** @brief Builds the Huffman binary tree from a probability table in memory.
+ *
+ *   @param prob_table the probability of each character
+ *   @return the root of the Huffman binary tree
+ */
+NODE *build_huffman_tree(float *prob_table);
+
 /** @brief Reads the probabilites of each character from the specified file and returns them in a table.
  * 
  *  @param prob_file the file to read the probabilities from
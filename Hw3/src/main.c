@@ -1,10 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <getopt.h>
 #include "prob_table.h"
 #include "huffman_tree.h"
 #include "encoder.h"
 #include "decoder.h"
+#include "codegen.h"
+#include "batch.h"
+#include "trainer.h"
+#include "pipeline.h"
+#include "container.h"
+#include "parallel_decoder.h"
+#include "compress.h"
 
 /** @brief Starts executing all the procedures of the program.
  *
@@ -27,28 +35,59 @@ void start(int argc, char **argv);
  *   @param s_flag       flag for creating the Huffman tree
  *   @param e_flag       flag for encoding a file
  *   @param d_flag       flag for decoding a file
+ *   @param g_flag       flag for generating a C header with the codebook
+ *   @param b_flag       flag for encoding a batch of files
+ *   @param t_flag       flag for training the probability table on a corpus
+ *   @param k_flag       flag for encoding a file into a container file with checksums
+ *   @param v_flag       flag for checking the checksums of a container file
+ *   @param m_flag       flag for decoding a file with many threads
+ *   @param c_flag       flag for encoding a file into a self-contained file
+ *   @param x_flag       flag for decoding a self-contained file
  *   @param sample_file  the file to read the cities from
  *   @param prob_file    the file to read or write the prbabilities
  *   @param data_file    the data file to encode
  *   @param encoded_file the file to read or write the encoded result
  *   @param decoded_file the file to write the decoded result
+ *   @param header_file  the C header to write the codebook to
+ *   @param batch_input  the directory or file list with the files to encode
+ *   @param output_dir   the directory to save the encoded files in
+ *   @param thread_count the number of worker threads, 0 for one per processor
+ *   @param snapshot_dir the directory with the snapshots of the training corpus
+ *   @param train_add    1 to add files to the training corpus or 0 to remove them
+ *   @param train_files  the files to add to or remove from the training corpus
+ *   @param train_count  the number of train_files
  *   @return void
  */
 void read_user_input(int argc, char **argv, int *p_flag, int *s_flag, int *e_flag, int *d_flag,
-                     char **sample_file, char **prob_file, char **data_file, char **encoded_file,
-                     char **decoded_file);
+                     int *g_flag, int *b_flag, int *t_flag, int *k_flag, int *v_flag,
+                     int *m_flag, int *c_flag, int *x_flag, char **sample_file,
+                     char **prob_file, char **data_file, char **encoded_file,
+                     char **decoded_file, char **header_file, char **batch_input,
+                     char **output_dir, int *thread_count, char **snapshot_dir,
+                     int *train_add, char ***train_files, int *train_count);
 
 /************************************ Function definitions **************************************/
 
 void start(int argc, char **argv)
 {
-    int p_flag = 0, s_flag = 0, e_flag = 0, d_flag = 0; /* Options the user chooses. */
+    /* Options the user chooses. */
+    int p_flag = 0, s_flag = 0, e_flag = 0, d_flag = 0, g_flag = 0, b_flag = 0, t_flag = 0;
+    int k_flag = 0, v_flag = 0, m_flag = 0, c_flag = 0, x_flag = 0;
     /* Filenames from command line arguments.*/
     char *sample_file = NULL, *prob_file = NULL, *data_file = NULL;
-    char *encoded_file = NULL, *decoded_file = NULL;
+    char *encoded_file = NULL, *decoded_file = NULL, *header_file = NULL;
+    char *batch_input = NULL, *output_dir = NULL;
+    int thread_count = 0; /* Worker threads, 0 for one per processor. */
+    /* Training corpus changes. */
+    char *snapshot_dir = NULL;
+    char **train_files = NULL;
+    int train_add = 0, train_count = 0;
 
-    read_user_input(argc, argv, &p_flag, &s_flag, &e_flag, &d_flag,
-                    &sample_file, &prob_file, &data_file, &encoded_file, &decoded_file);
+    read_user_input(argc, argv, &p_flag, &s_flag, &e_flag, &d_flag, &g_flag, &b_flag, &t_flag,
+                    &k_flag, &v_flag, &m_flag, &c_flag, &x_flag, &sample_file, &prob_file,
+                    &data_file, &encoded_file, &decoded_file, &header_file, &batch_input,
+                    &output_dir, &thread_count, &snapshot_dir, &train_add, &train_files,
+                    &train_count);
     
     /* Program functionality depends on the option the user chose from the command line. */
     if (p_flag == 1)
@@ -67,36 +106,102 @@ void start(int argc, char **argv)
     {
         NODE *huffman_tree_root = generate_huffman_tree(prob_file);
         char **huffman_table = generate_huffman_table(huffman_tree_root); 
-        encode(huffman_table, data_file, encoded_file);
+        encode_pipelined(huffman_table, data_file, encoded_file);
         free_huffman_tree(huffman_tree_root);
         free_huffman_table(huffman_table);    
     }
     else if (d_flag == 1)
     {
         NODE *huffman_tree_root = generate_huffman_tree(prob_file);
-        decode(huffman_tree_root, encoded_file, decoded_file);
+        /* Container files from -k are recognized by their first bytes. */
+        if (is_container(encoded_file) == 1)
+        {
+            decode_container(huffman_tree_root, encoded_file, decoded_file);
+        }
+        else
+        {
+            decode_pipelined(huffman_tree_root, encoded_file, decoded_file);
+        }
         free_huffman_tree(huffman_tree_root);        
     }
+    else if (g_flag == 1)
+    {
+        NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+        char **huffman_table = generate_huffman_table(huffman_tree_root);
+        emit_c_codebook(huffman_tree_root, huffman_table, prob_file, header_file);
+        free_huffman_tree(huffman_tree_root);
+        free_huffman_table(huffman_table);
+    }
+    else if (b_flag == 1)
+    {
+        /* The Huffman table is built once and shared by all the files of the batch. */
+        NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+        char **huffman_table = generate_huffman_table(huffman_tree_root);
+        batch_encode(huffman_table, batch_input, output_dir, thread_count);
+        free_huffman_tree(huffman_tree_root);
+        free_huffman_table(huffman_table);
+    }
+    else if (t_flag == 1)
+    {
+        train_prob_table(snapshot_dir, prob_file, train_add, train_files, train_count);
+    }
+    else if (k_flag == 1)
+    {
+        NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+        char **huffman_table = generate_huffman_table(huffman_tree_root);
+        encode_container(huffman_table, data_file, encoded_file);
+        free_huffman_tree(huffman_tree_root);
+        free_huffman_table(huffman_table);
+    }
+    else if (v_flag == 1)
+    {
+        verify_container(encoded_file, thread_count);
+    }
+    else if (m_flag == 1)
+    {
+        NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+        decode_parallel(huffman_tree_root, encoded_file, decoded_file, thread_count);
+        free_huffman_tree(huffman_tree_root);
+    }
+    else if (c_flag == 1)
+    {
+        compress_file(data_file, encoded_file);
+    }
+    else if (x_flag == 1)
+    {
+        decompress_file(encoded_file, decoded_file);
+    }
 }
 
 void read_user_input(int argc, char **argv, int *p_flag, int *s_flag, int *e_flag, int *d_flag,
-                     char **sample_file, char **prob_file, char **data_file, char **encoded_file,
-                     char **decoded_file)
+                     int *g_flag, int *b_flag, int *t_flag, int *k_flag, int *v_flag,
+                     int *m_flag, int *c_flag, int *x_flag, char **sample_file,
+                     char **prob_file, char **data_file, char **encoded_file,
+                     char **decoded_file, char **header_file, char **batch_input,
+                     char **output_dir, int *thread_count, char **snapshot_dir,
+                     int *train_add, char ***train_files, int *train_count)
 {
     int option; /* To save the command line options. */
+    /* Options that only have a long name. Each one is returned as the character next to it. */
+    struct option long_options[] = {
+        {"emit-c", no_argument, NULL, 'g'},
+        {"verify", no_argument, NULL, 'v'},
+        {NULL, 0, NULL, 0}
+    };
 
     /* If argc == 1(the program name), then no arguments have been given. */
     if (argc == 1)
     {
         printf("No arguments given\n");
-        printf("One of -p, -s, -e or -d must be used\n");
+        printf("One of -p, -s, -e, -d, -b, -t, -k, -m, -c, -x, --emit-c or --verify must be used\n");
         exit(EXIT_FAILURE);
     }
 
     /*
-     * Scans the command line arguments and searches for options 'p', 's', 'e' and 'd'.
+     * Scans the command line arguments and searches for options 'p', 's', 'e', 'd', 'b', 't',
+     * 'k', 'm', 'c', 'x', "emit-c" and "verify".
      */
-    while ((option = getopt(argc, argv, "psed")) != -1)
+    while ((option = getopt_long(argc, argv, "psedbtkmcx", long_options, NULL)) != -1)
     {
         switch (option)
         {
@@ -153,19 +258,144 @@ void read_user_input(int argc, char **argv, int *p_flag, int *s_flag, int *e_fla
             *decoded_file = argv[4];
             break;
 
+        /* Generating C header arguments. */
+        case (int)'g':
+            if (argc != 4)
+            {
+                printf("Invalid arguments.\n");
+                printf("To use --emit-c: ./huffman --emit-c probfile.txt codebook.h\n");
+                exit(EXIT_FAILURE);
+            }
+            *g_flag = 1;
+            *prob_file = argv[2];
+            *header_file = argv[3];
+            break;
+
+        /* Batch encoding arguments. The number of worker threads is optional. */
+        case (int)'b':
+            if (argc != 5 && argc != 6)
+            {
+                printf("Invalid arguments.\n");
+                printf("To use -b: ./huffman -b probfile.txt files.txt|directory outdir [threads]\n");
+                exit(EXIT_FAILURE);
+            }
+            *b_flag = 1;
+            *prob_file = argv[2];
+            *batch_input = argv[3];
+            *output_dir = argv[4];
+            if (argc == 6)
+            {
+                *thread_count = atoi(argv[5]);
+            }
+            break;
+
+        /* Training arguments. Any number of files can be added or removed at once. */
+        case (int)'t':
+            if (argc < 6 || (strcmp(argv[4], "add") != 0 && strcmp(argv[4], "remove") != 0))
+            {
+                printf("Invalid arguments.\n");
+                printf("To use -t: ./huffman -t snapshots probfile.txt add|remove file1.txt ...\n");
+                exit(EXIT_FAILURE);
+            }
+            *t_flag = 1;
+            *snapshot_dir = argv[2];
+            *prob_file = argv[3];
+            *train_add = (strcmp(argv[4], "add") == 0);
+            *train_files = argv + 5;
+            *train_count = argc - 5;
+            /* The files are not options, so getopt() does not need to scan them. */
+            optind = argc;
+            break;
+
+        /* Container encoding arguments. */
+        case (int)'k':
+            if (argc != 5)
+            {
+                printf("Invalid arguments.\n");
+                printf("To use -k: ./huffman -k probfile.txt data.txt data.txt.hfb\n");
+                exit(EXIT_FAILURE);
+            }
+            *k_flag = 1;
+            *prob_file = argv[2];
+            *data_file = argv[3];
+            *encoded_file = argv[4];
+            break;
+
+        /* Parallel decoding arguments. The number of threads is optional. */
+        case (int)'m':
+            if (argc != 5 && argc != 6)
+            {
+                printf("Invalid arguments.\n");
+                printf("To use -m: ./huffman -m probfile.txt data.txt.enc data.txt.new [threads]\n");
+                exit(EXIT_FAILURE);
+            }
+            *m_flag = 1;
+            *prob_file = argv[2];
+            *encoded_file = argv[3];
+            *decoded_file = argv[4];
+            if (argc == 6)
+            {
+                *thread_count = atoi(argv[5]);
+            }
+            break;
+
+        /* Self-contained encoding arguments. No probability file is needed. */
+        case (int)'c':
+            if (argc != 4)
+            {
+                printf("Invalid arguments.\n");
+                printf("To use -c: ./huffman -c data.txt data.txt.hfx\n");
+                exit(EXIT_FAILURE);
+            }
+            *c_flag = 1;
+            *data_file = argv[2];
+            *encoded_file = argv[3];
+            break;
+
+        /* Self-contained decoding arguments. */
+        case (int)'x':
+            if (argc != 4)
+            {
+                printf("Invalid arguments.\n");
+                printf("To use -x: ./huffman -x data.txt.hfx data.txt.new\n");
+                exit(EXIT_FAILURE);
+            }
+            *x_flag = 1;
+            *encoded_file = argv[2];
+            *decoded_file = argv[3];
+            break;
+
+        /* Container checking arguments. The number of worker threads is optional. */
+        case (int)'v':
+            if (argc != 3 && argc != 4)
+            {
+                printf("Invalid arguments.\n");
+                printf("To use --verify: ./huffman --verify data.txt.hfb [threads]\n");
+                exit(EXIT_FAILURE);
+            }
+            *v_flag = 1;
+            *encoded_file = argv[2];
+            if (argc == 4)
+            {
+                *thread_count = atoi(argv[3]);
+            }
+            break;
+
         /* Case when an unrecognized option is given or there is a missing argument. */
         case (int)'?':
             /*
              * Case '?' means there is an error with arguments, therefore the program
              * needs to be terminated.
              */      
-            printf("One of -p, -s, -e or -d must be used\n");      
+            printf("One of -p, -s, -e, -d, -b, -t, -k, -m, -c, -x, --emit-c or --verify must be used\n");      
             exit(EXIT_FAILURE);
         }
     }
-    if (*p_flag == 0 && *s_flag == 0 && *e_flag == 0 && *d_flag == 0)
+    if (*p_flag == 0 && *s_flag == 0 && *e_flag == 0 && *d_flag == 0 && *g_flag == 0 &&
+        *b_flag == 0 && *t_flag == 0 && *k_flag == 0 && *v_flag == 0 && *m_flag == 0 &&
+        *c_flag == 0 && *x_flag == 0)
     {
-        printf("One of -p, -s, -e or -d must be used\n");      
+        printf("One of -p, -s, -e, -d, -b, -t, -k, -m, -c, -x, --emit-c or --verify must be used\n");      
         exit(EXIT_FAILURE);
     }
 }
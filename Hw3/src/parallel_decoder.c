@@ -0,0 +1,281 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include "parallel_decoder.h"
+
+/** @brief Writes decoded characters to the output file.
+ *
+ *   @param symbols  the characters
+ *   @param count    the number of characters
+ *   @param fp_write the output file
+ *   @return void
+ */
+static void write_symbols(char *symbols, size_t count, FILE *fp_write)
+{
+    if (count > 0 && fwrite(symbols, 1, count, fp_write) != count)
+    {
+        printf("Error: Unable to write the output file\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/** @brief Runs a thread for each chunk and waits for all of them.
+ *
+ *   @param chunks       the chunks
+ *   @param threads      room for a thread for each chunk
+ *   @param thread_count the number of chunks
+ *   @param work         the thread to run for each chunk
+ *   @return void
+ */
+static void run_chunks(CHUNK *chunks, pthread_t *threads, int thread_count,
+                       void *(*work)(void *))
+{
+    int i = 0;
+
+    for (i = 0; i < thread_count; i++)
+    {
+        if (pthread_create(&threads[i], NULL, work, &chunks[i]) != 0)
+        {
+            printf("Error: Could not create worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+void decode_parallel(NODE *huffman_tree_root, char *encoded_file, char *decoded_file,
+                     int thread_count)
+{
+    int i = 0;
+    size_t data_size = 0;
+    size_t bits_before = 0;       /* The number of bits before the chunk, as first split. */
+    FSM_STATE state = {0, 0, 0};  /* Where the decoder really is. */
+    char tail[8];                 /* The characters of the bits left at the end. */
+    char *data = NULL;
+    CHUNK *chunks = NULL;
+    pthread_t *threads = NULL;
+    FSM *fsm = build_fsm_decoder(huffman_tree_root);
+    FILE *fp_read = NULL, *fp_write = NULL;
+
+    if ((fp_read = fopen(encoded_file, "r")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", encoded_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp_write = fopen(decoded_file, "w")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", decoded_file);
+        exit(EXIT_FAILURE);
+    }
+
+    /* The whole encoded file is mapped in memory, so the threads can start anywhere. */
+    fseek(fp_read, 0, SEEK_END);
+    data_size = ftell(fp_read);
+    if (data_size > 0)
+    {
+        data = (char *)mmap(NULL, data_size, PROT_READ, MAP_PRIVATE, fileno(fp_read), 0);
+        if (data == MAP_FAILED)
+        {
+            printf("\"%s\" file cannot be read\n", encoded_file);
+            exit(EXIT_FAILURE);
+        }
+    }
+    fclose(fp_read);
+
+    if (thread_count <= 0)
+    {
+        thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    /* A chunk shorter than a segment would be decoded twice. */
+    if ((size_t)thread_count > data_size / SYNC_INTERVAL)
+    {
+        thread_count = (int)(data_size / SYNC_INTERVAL);
+    }
+    if (thread_count < 1)
+    {
+        thread_count = 1;
+    }
+
+    chunks = (CHUNK *)malloc(thread_count * sizeof(CHUNK));
+    threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    if (chunks == NULL || threads == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Splits the data in chunks of equal size and counts their bits at the same time. */
+    for (i = 0; i < thread_count; i++)
+    {
+        chunks[i].fsm = fsm;
+        chunks[i].data = data;
+        chunks[i].start = data_size / thread_count * i;
+        chunks[i].end = (i == thread_count - 1) ? data_size : data_size / thread_count * (i + 1);
+    }
+    run_chunks(chunks, threads, thread_count, count_chunk_bits);
+
+    /* Moves the start of each chunk forward to the end of the byte of bits it is in. */
+    for (i = 1; i < thread_count; i++)
+    {
+        size_t position = chunks[i].start;
+        size_t missing = 0;   /* The number of bits until the end of the byte. */
+
+        bits_before += chunks[i - 1].bit_count;
+        missing = (8 - bits_before % 8) % 8;
+        while (missing > 0 && position < data_size)
+        {
+            if (data[position] == '0' || data[position] == '1')
+            {
+                missing--;
+            }
+            position++;
+        }
+        chunks[i].start = position;
+        chunks[i - 1].end = position;
+    }
+    run_chunks(chunks, threads, thread_count, decode_chunk);
+
+    /* The first chunk really starts at the root. The others are corrected as they are joined. */
+    for (i = 0; i < thread_count; i++)
+    {
+        join_chunk(&chunks[i], &state, fp_write);
+        free(chunks[i].symbols);
+        free(chunks[i].sync_points);
+    }
+    write_symbols(tail, fsm_decode_flush(fsm, &state, tail), fp_write);
+
+    if (fclose(fp_write) != 0)
+    {
+        printf("Error: Unable to write the output file\n");
+        exit(EXIT_FAILURE);
+    }
+    printf("Decoding done. Result in: \"%s\"\n", decoded_file);
+    if (data_size > 0)
+    {
+        munmap(data, data_size);
+    }
+    free(chunks);
+    free(threads);
+    free_fsm_decoder(fsm);
+}
+
+void *count_chunk_bits(void *chunk)
+{
+    CHUNK *c = (CHUNK *)chunk;
+    size_t position = c->start;
+    size_t bit_count = 0;
+
+    /* Clearing the lowest bit of '0' and '1' leaves '0', so 8 characters are checked at once. */
+    for (; position + 8 <= c->end; position += 8)
+    {
+        unsigned long long word = 0;
+        int b = 0;
+
+        memcpy(&word, c->data + position, 8);
+        if ((word & 0xFEFEFEFEFEFEFEFEULL) == 0x3030303030303030ULL)
+        {
+            bit_count += 8;
+            continue;
+        }
+        /* Other characters are not bits, like decode() does. */
+        for (b = 0; b < 8; b++)
+        {
+            bit_count += ((c->data[position + b] & 0xFE) == '0');
+        }
+    }
+    for (; position < c->end; position++)
+    {
+        bit_count += ((c->data[position] & 0xFE) == '0');
+    }
+    c->bit_count = bit_count;
+    return NULL;
+}
+
+void *decode_chunk(void *chunk)
+{
+    CHUNK *c = (CHUNK *)chunk;
+    FSM_STATE state = {0, 0, 0};
+    size_t position = c->start;
+    size_t k = 0;
+
+    c->symbol_count = 0;
+    c->sync_count = (c->end - c->start + SYNC_INTERVAL - 1) / SYNC_INTERVAL;
+    /* At most one character per bit. */
+    c->symbols = (char *)malloc(c->end - c->start + 1);
+    c->sync_points = (SYNC_POINT *)malloc((c->sync_count + 1) * sizeof(SYNC_POINT));
+    if (c->symbols == NULL || c->sync_points == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (k = 0; k < c->sync_count; k++)
+    {
+        size_t size = (c->end - position < SYNC_INTERVAL) ? c->end - position : SYNC_INTERVAL;
+
+        c->symbol_count += fsm_decode_text(c->fsm, &state, c->data + position, size,
+                                           c->symbols + c->symbol_count);
+        position += size;
+        c->sync_points[k].state = state;
+        c->sync_points[k].symbol_count = c->symbol_count;
+    }
+    return NULL;
+}
+
+void join_chunk(CHUNK *chunk, FSM_STATE *state, FILE *fp_write)
+{
+    size_t k = 0;
+    size_t position = chunk->start;
+    char fixed[SYNC_INTERVAL];  /* The characters of a segment decoded again. */
+
+    /* The speculative decoding started at the root, so it is correct if the decoder is there. */
+    if (state->state == 0 && state->pending_count == 0)
+    {
+        write_symbols(chunk->symbols, chunk->symbol_count, fp_write);
+        if (chunk->sync_count > 0)
+        {
+            *state = chunk->sync_points[chunk->sync_count - 1].state;
+        }
+        return;
+    }
+
+    for (k = 0; k < chunk->sync_count; k++)
+    {
+        SYNC_POINT *sync = &chunk->sync_points[k];
+        size_t size = (chunk->end - position < SYNC_INTERVAL) ? chunk->end - position
+                                                               : SYNC_INTERVAL;
+
+        write_symbols(fixed, fsm_decode_text(chunk->fsm, state, chunk->data + position, size,
+                                             fixed), fp_write);
+        position += size;
+
+        /* Both decoders are in the same state, so the speculative decoding is correct from here. */
+        if (state->state == sync->state.state && state->pending == sync->state.pending &&
+            state->pending_count == sync->state.pending_count)
+        {
+            write_symbols(chunk->symbols + sync->symbol_count,
+                          chunk->symbol_count - sync->symbol_count, fp_write);
+            *state = chunk->sync_points[chunk->sync_count - 1].state;
+            return;
+        }
+    }
+}
+
+#ifdef TEST_M
+int main(int argc, char **argv)
+{
+    char *prob_file = argv[1];
+    char *encoded_file = argv[2];
+    char *decoded_file = argv[3];
+
+    NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+    decode_parallel(huffman_tree_root, encoded_file, decoded_file, atoi(argv[4]));
+    free_huffman_tree(huffman_tree_root);
+    return 0;
+}
+#endif
@@ -0,0 +1,84 @@
+#ifndef PARALLEL_DECODER
+#define PARALLEL_DECODER
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "huffman_tree.h"
+#include "fsm_decoder.h"
+
+/** @brief Number of characters of encoded data between two sync points of a chunk. */
+#define SYNC_INTERVAL 4096
+
+/** @brief Where the speculative decoding of a chunk is at the end of a segment. */
+typedef struct {
+    FSM_STATE state;     /* The state of the decoder after the segment. */
+    size_t symbol_count; /* The number of characters decoded up to there. */
+} SYNC_POINT;
+
+/** @brief A part of the encoded data decoded speculatively by one thread.
+ *
+ *  The thread starts at the root of the Huffman binary tree at start, without knowing
+ *  whether a code really starts there. start always has a whole number of bytes of bits
+ *  before it, so both decodings keep the same pending bits. Huffman codes synchronize
+ *  quickly, so after a few codes its output is usually the correct one.
+ *
+ *  The chunk is decoded in segments of SYNC_INTERVAL characters and the state of the
+ *  decoder is only kept at the end of each segment.
+ */
+typedef struct {
+    FSM *fsm;                 /* The finite-state machine of the Huffman binary tree. */
+    char *data;               /* All the encoded data. */
+    size_t start;             /* Where the chunk starts. */
+    size_t end;               /* Where the next chunk starts. */
+    size_t bit_count;         /* The number of '0' and '1' characters of the chunk. */
+    char *symbols;            /* The characters decoded. */
+    size_t symbol_count;      /* The number of characters decoded. */
+    SYNC_POINT *sync_points;  /* sync_points[k] is the state at the end of segment k. */
+    size_t sync_count;        /* The number of segments. */
+} CHUNK;
+
+/** @brief Decodes a file produced by encode() using many threads.
+ *
+ *   The encoded data is split in chunks and each one is decoded by a thread a byte at a
+ *   time, starting at the beginning of the chunk as if a code started there. The chunks
+ *   are then joined in order. Where the decoder really is at the start of a chunk is known
+ *   once the previous chunk is joined. If it is at the root, the chunk is correct.
+ *   Otherwise the chunk is decoded again a segment at a time until the decoder is in the
+ *   same state as the speculative decoding at the end of a segment, which usually takes
+ *   one segment. The result is the same as the one of decode().
+ *
+ *   @param huffman_tree_root the root of the Huffman binary tree
+ *   @param encoded_file      the file to get the encoded data to decode
+ *   @param decoded_file      the file name of the output file to save the decoded data in
+ *   @param thread_count      the number of threads, or 0 to use one per processor
+ *   @return void
+ */
+void decode_parallel(NODE *huffman_tree_root, char *encoded_file, char *decoded_file,
+                     int thread_count);
+
+/** @brief Thread that counts the '0' and '1' characters of a chunk.
+ *
+ *   @param chunk the CHUNK to count
+ *   @return NULL
+ */
+void *count_chunk_bits(void *chunk);
+
+/** @brief Thread that decodes a chunk speculatively.
+ *
+ *   @param chunk the CHUNK to decode
+ *   @return NULL
+ */
+void *decode_chunk(void *chunk);
+
+/** @brief Joins a chunk to the decoded data that comes before it.
+ *
+ *   @param chunk    the chunk to join
+ *   @param state    where the decoder really is at the start of the chunk, updated to where
+ *                   it is at the end of the chunk
+ *   @param fp_write the file to save the decoded data of the chunk in
+ *   @return void
+ */
+void join_chunk(CHUNK *chunk, FSM_STATE *state, FILE *fp_write);
+
+#endif
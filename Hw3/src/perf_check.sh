@@ -0,0 +1,274 @@
+#!/bin/bash
+###############################################
+# Round trip and speed checks for the huffman program
+# './perf_check.sh bench'           checks the round trips and measures each stage
+# './perf_check.sh check [percent]' also fails when a stage is slower than the baseline
+#                                   by more than percent (25 by default)
+# './perf_check.sh baseline'        saves the speed of each stage as the new baseline
+# Each stage is compared through its speed relative to a reference stage of the same run
+# (-p, -e or -d), so the baseline holds on other machines. The speeds themselves are also
+# compared when the baseline was saved on the same kind of machine.
+###############################################
+MODE=${1:-bench}
+THRESHOLD=${2:-25}
+HUFFMAN=./huffman
+CC=${CC:-cc}        # compiles the programs generated with --emit-c
+SUPPLEMENTARY=../as3-supplementary
+BASELINE=perf_baseline.txt
+RUNS=5              # each stage is timed this many times and the fastest run is kept
+BENCH_COPIES=16     # the speed is measured on this many copies of sample.txt
+FUZZ_RUNS=20        # random files of random sizes checked after the golden corpora
+WORK=$(mktemp -d)
+FAILED=0
+
+trap 'rm -rf "$WORK"' EXIT
+
+if [ "$MODE" != bench ] && [ "$MODE" != check ] && [ "$MODE" != baseline ]; then
+    echo "Usage: ./perf_check.sh bench|check|baseline [percent]"
+    exit 1
+fi
+if [ ! -x "$HUFFMAN" ]; then
+    echo "\"$HUFFMAN\" not found, run make first"
+    exit 1
+fi
+
+# Runs the huffman program without its messages. Fails the check when it fails.
+run() {
+    if ! "$HUFFMAN" "$@" > "$WORK/log" 2>&1; then
+        echo "FAIL: huffman $* ($(tail -n 1 "$WORK/log"))" >&2
+        FAILED=1
+        return 1
+    fi
+}
+
+# Runs a program generated with --emit-c on a file. Fails the check when it fails.
+run_codec() {
+    if ! "$1" "$2" < "$3" > "$4" 2> "$WORK/log"; then
+        echo "FAIL: $(basename "$1") $2 $(basename "$3") ($(tail -n 1 "$WORK/log"))" >&2
+        FAILED=1
+        return 1
+    fi
+}
+
+# Compiles the header generated with --emit-c for a corpus into a program that encodes
+# ('e') or decodes ('d') its standard input.
+build_codec() {
+    local name=$1
+
+    if ! "$CC" -std=c99 -O2 -include "$WORK/$name.h" -o "$WORK/$name.codec" "$WORK/codec.c" \
+        > "$WORK/log" 2>&1; then
+        echo "FAIL: $CC cannot compile the --emit-c header of $name ($(tail -n 1 "$WORK/log"))"
+        FAILED=1
+        return 1
+    fi
+}
+
+# Prints a string that tells machines apart: architecture, processors and processor model.
+machine_id() {
+    echo "$(uname -m)/$(getconf _NPROCESSORS_ONLN)/$(awk -F': *' '/^model name/ { print $2; exit }' \
+        /proc/cpuinfo 2>/dev/null)" | tr ' ' '_'
+}
+
+# Compares a decoded file with the original.
+same() {
+    if ! cmp -s "$1" "$2"; then
+        echo "FAIL: $(basename "$2") does not match $(basename "$1") ($3)"
+        FAILED=1
+    fi
+}
+
+# Encodes and decodes a corpus in every format, with the probabilities of the corpus itself.
+round_trip() {
+    local corpus=$1
+    local name=$2
+    local prob="$WORK/$name.prob"
+
+    run -p "$corpus" "$prob" || return
+    run -e "$prob" "$corpus" "$WORK/$name.enc" && run -d "$prob" "$WORK/$name.enc" "$WORK/$name.d" &&
+        same "$corpus" "$WORK/$name.d" "-e/-d"
+    run -m "$prob" "$WORK/$name.enc" "$WORK/$name.m" 4 && same "$corpus" "$WORK/$name.m" "-m"
+    run -k "$prob" "$corpus" "$WORK/$name.hfb" && run --verify "$WORK/$name.hfb" &&
+        run -d "$prob" "$WORK/$name.hfb" "$WORK/$name.k" && same "$corpus" "$WORK/$name.k" "-k/-d"
+    run -c "$corpus" "$WORK/$name.hfx" && run --verify "$WORK/$name.hfx" &&
+        run -x "$WORK/$name.hfx" "$WORK/$name.x" && same "$corpus" "$WORK/$name.x" "-c/-x"
+    # The generated header writes the same encoded data as -e.
+    run --emit-c "$prob" "$WORK/$name.h" && build_codec "$name" &&
+        run_codec "$WORK/$name.codec" e "$corpus" "$WORK/$name.cenc" &&
+        same "$WORK/$name.enc" "$WORK/$name.cenc" "--emit-c encoding" &&
+        run_codec "$WORK/$name.codec" d "$WORK/$name.enc" "$WORK/$name.c" &&
+        same "$corpus" "$WORK/$name.c" "--emit-c decoding"
+}
+
+# Prints the time of a command in seconds, the fastest of RUNS runs.
+best_time() {
+    local i=0
+    local best=""
+
+    for ((i = 0; i < RUNS; i++)); do
+        local start=$(date +%s%N)
+        "$@" || return 1
+        local end=$(date +%s%N)
+        if [ -z "$best" ] || [ $((end - start)) -lt "$best" ]; then
+            best=$((end - start))
+        fi
+    done
+    awk -v ns="$best" 'BEGIN { printf "%.6f", ns / 1e9 }'
+}
+
+# Measures a stage and saves its speed in MB/s of the data file, and its speed relative to
+# a reference stage measured before it, or to itself for '-'.
+measure() {
+    local stage=$1
+    local reference=$2
+    shift 2
+    local seconds
+
+    # best_time runs in a subshell, so its failure is recorded here.
+    seconds=$(best_time "$@") || { FAILED=1; return; }
+    awk -v stage="$stage" -v reference="$reference" -v bytes="$DATA_SIZE" -v s="$seconds" '
+        $1 == reference { reference_speed = $2 }
+        END {
+            speed = bytes / 1e6 / (s > 0 ? s : 1e-6)
+            if (reference == "-") reference_speed = speed
+            printf "%-8s %10.2f %8.3f\n", stage, speed, speed / reference_speed
+        }' "$WORK/results" >> "$WORK/results"
+}
+
+########## Golden corpora ##########
+echo "Checking round trips..."
+cp "$SUPPLEMENTARY/sample.txt" "$WORK/sample.txt"
+cp "$SUPPLEMENTARY/data.txt" "$WORK/data.txt"
+# Random characters from the whole table: bytes above 127 are folded back below 128.
+head -c 200000 /dev/urandom | LC_ALL=C tr '\200-\377' '\000-\177' > "$WORK/random.txt"
+# A single character, so one code is 1 bit long and the others are as long as they get.
+head -c 100000 /dev/zero | tr '\0' 'a' > "$WORK/single.txt"
+# All 128 characters, a few times each.
+for ((i = 0; i < 128 * 4; i++)); do
+    printf "\\$(printf %03o $((i % 128)))"
+done > "$WORK/all.txt"
+
+# Encodes ('e') or decodes ('d') the standard input with the header included by the compiler.
+cat > "$WORK/codec.c" << 'EOF'
+#include <string.h>
+
+int main(int argc, char **argv)
+{
+    if (argc == 2 && strcmp(argv[1], "e") == 0)
+    {
+        return huffman_codebook_encode(stdin, stdout) < 0;
+    }
+    return huffman_codebook_decode(stdin, stdout) < 0;
+}
+EOF
+
+for corpus in sample data random single all; do
+    round_trip "$WORK/$corpus.txt" "$corpus"
+done
+
+########## Batch encoding and training ##########
+# Every corpus is encoded at once with the probabilities of sample.txt.
+mkdir "$WORK/batch" "$WORK/batch.out"
+for corpus in sample data random single all; do
+    cp "$WORK/$corpus.txt" "$WORK/batch/"
+done
+if run -b "$WORK/sample.prob" "$WORK/batch" "$WORK/batch.out" 4; then
+    for corpus in sample data random single all; do
+        run -d "$WORK/sample.prob" "$WORK/batch.out/$corpus.txt.enc" "$WORK/$corpus.b" &&
+            same "$WORK/$corpus.txt" "$WORK/$corpus.b" "-b/-d"
+    done
+fi
+# Removing files from the corpus gives the probabilities of the files left.
+mkdir "$WORK/snapshots"
+run -t "$WORK/snapshots" "$WORK/train.prob" add "$WORK/sample.txt" "$WORK/data.txt" \
+    "$WORK/random.txt" &&
+    run -t "$WORK/snapshots" "$WORK/train.prob" remove "$WORK/data.txt" "$WORK/random.txt" &&
+    same "$WORK/sample.prob" "$WORK/train.prob" "-t add/remove"
+
+########## Random files ##########
+# Random sizes, including empty files, with a random number of different characters.
+for ((i = 0; i < FUZZ_RUNS; i++)); do
+    size=$((RANDOM % 5000))
+    [ $i -eq 0 ] && size=0
+    last=$(printf %03o $((RANDOM % 127 + 1)))
+    head -c "$size" /dev/urandom | LC_ALL=C tr '\200-\377' '\000-\177' |
+        LC_ALL=C tr -c "\\000-\\$last" 'x' > "$WORK/fuzz.txt"
+    run -k "$WORK/sample.prob" "$WORK/fuzz.txt" "$WORK/fuzz.hfb" &&
+        run -d "$WORK/sample.prob" "$WORK/fuzz.hfb" "$WORK/fuzz.k" &&
+        same "$WORK/fuzz.txt" "$WORK/fuzz.k" "-k/-d, $size characters"
+    run -c "$WORK/fuzz.txt" "$WORK/fuzz.hfx" && run -x "$WORK/fuzz.hfx" "$WORK/fuzz.x" &&
+        same "$WORK/fuzz.txt" "$WORK/fuzz.x" "-c/-x, $size characters"
+done
+
+if [ $FAILED -ne 0 ]; then
+    echo "Round trips failed"
+    exit 1
+fi
+echo "Round trips passed"
+
+########## Speed of each stage ##########
+B="$WORK/bench"
+# The same data as one file, and as BENCH_COPIES files for -b.
+mkdir "$B.files" "$B.batch" "$B.snapshots"
+for ((i = 0; i < BENCH_COPIES; i++)); do
+    cp "$WORK/sample.txt" "$B.files/sample$i.txt"
+    cat "$WORK/sample.txt"
+done > "$B.txt"
+DATA_SIZE=$(wc -c < "$B.txt")
+: > "$WORK/results"
+
+echo "Measuring each stage on $DATA_SIZE characters (MB/s of data, speed relative to a reference)..."
+measure count    -       run -p "$B.txt" "$B.prob"
+measure encode   -       run -e "$B.prob" "$B.txt" "$B.enc"
+measure decode   -       run -d "$B.prob" "$B.enc" "$B.d"
+measure pdecode  decode  run -m "$B.prob" "$B.enc" "$B.m"
+measure kencode  encode  run -k "$B.prob" "$B.txt" "$B.hfb"
+measure kdecode  decode  run -d "$B.prob" "$B.hfb" "$B.k"
+measure verify   count   run --verify "$B.hfb"
+measure compress encode  run -c "$B.txt" "$B.hfx"
+measure extract  decode  run -x "$B.hfx" "$B.x"
+measure batch    encode  run -b "$B.prob" "$B.files" "$B.batch"
+measure train    count   run -t "$B.snapshots" "$B.tprob" add "$B.txt"
+# The header of sample.txt has the codes of bench.prob, made from copies of sample.txt.
+measure cencode  encode  run_codec "$WORK/sample.codec" e "$B.txt" "$B.cenc"
+measure cdecode  decode  run_codec "$WORK/sample.codec" d "$B.enc" "$B.c"
+cat "$WORK/results"
+
+if [ $FAILED -ne 0 ]; then
+    exit 1
+fi
+
+if [ "$MODE" = baseline ]; then
+    { echo "# machine $(machine_id)"; cat "$WORK/results"; } > "$BASELINE"
+    echo "Baseline saved in \"$BASELINE\""
+elif [ "$MODE" = check ]; then
+    if [ ! -f "$BASELINE" ]; then
+        echo "\"$BASELINE\" not found, run ./perf_check.sh baseline first"
+        exit 1
+    fi
+    if [ "$(awk '$2 == "machine" { print $3; exit }' "$BASELINE")" = "$(machine_id)" ]; then
+        SAME_MACHINE=1
+        echo "Comparing relative speeds and speeds, the baseline was saved on this kind of machine"
+    else
+        SAME_MACHINE=0
+        echo "Comparing relative speeds only, the baseline was saved on another kind of machine"
+    fi
+    # A stage fails when its relative speed, or its speed on the same kind of machine, is
+    # lower than in the baseline by more than THRESHOLD percent.
+    if ! awk -v threshold="$THRESHOLD" -v same_machine="$SAME_MACHINE" '
+        NR == FNR { if ($1 != "#") { speed[$1] = $2; ratio[$1] = $3 } next }
+        ($1 in speed) {
+            change = ($3 / ratio[$1] - 1) * 100
+            speed_change = ($2 / speed[$1] - 1) * 100
+            status = (change < -threshold) ? "SLOWER" : "ok"
+            if (same_machine && speed_change < -threshold) status = "SLOWER"
+            printf "%-8s %8.3f %8.3f %+7.1f%%", $1, ratio[$1], $3, change
+            if (same_machine) printf "  speed %+7.1f%%", speed_change
+            printf "  %s\n", status
+            if (status != "ok") failed = 1
+        }
+        END { exit failed }' "$BASELINE" "$WORK/results"; then
+        echo "Some stages are more than $THRESHOLD% slower than \"$BASELINE\""
+        exit 1
+    fi
+    echo "No stage is more than $THRESHOLD% slower than \"$BASELINE\""
+fi
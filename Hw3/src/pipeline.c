@@ -0,0 +1,291 @@
+#include "pipeline.h"
+
+void encode_pipelined(char **huffman_table, char *data_file, char *encoded_file)
+{
+    int i = 0;
+    int max_length = 0;      /* Length of the longest Huffman code. */
+    int *code_lengths = NULL;
+    int last_block = 0;      /* Whether the current block marks the end of the file. */
+    unsigned long k = 0;
+    IO_PIPELINE pipeline;
+    pthread_t reader, writer;
+
+    code_lengths = (int *)malloc(MAX_ASCII * sizeof(int));
+    if (code_lengths == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        code_lengths[i] = strlen(huffman_table[i]);
+        if (code_lengths[i] > max_length)
+        {
+            max_length = code_lengths[i];
+        }
+    }
+
+    start_pipeline(&pipeline, data_file, encoded_file, &reader, &writer);
+
+    /* Compute stage. Encodes the blocks in the order the reader thread filled them. */
+    for (k = 0;; k++)
+    {
+        BLOCK *block = &pipeline.slots[k % PIPELINE_SLOTS];
+        long output_size = 0;
+
+        wait_for_count(&pipeline, &pipeline.read_count, k);
+
+        if (block->input_size * max_length > block->output_capacity)
+        {
+            block->output_capacity = block->input_size * max_length;
+            block->output = (char *)realloc(block->output, block->output_capacity);
+            if (block->output == NULL)
+            {
+                printf("Error: Unable to Allocate Memory using realloc\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        output_size = encode_block(huffman_table, code_lengths, block->input, block->input_size,
+                                   block->output);
+        if (output_size < 0)
+        {
+            printf("File cannot have ASCII characters with value above 127\n");
+            exit(EXIT_FAILURE);
+        }
+        block->output_size = (size_t)output_size;
+
+        /* The block may be refilled as soon as it is handed over, so the end is checked first. */
+        last_block = (block->input_size == 0);
+        set_count(&pipeline, &pipeline.computed_count, k + 1);
+        if (last_block)
+        {
+            break;
+        }
+    }
+
+    stop_pipeline(&pipeline, reader, writer);
+    printf("Encoding done. Result in: \"%s\"\n", encoded_file);
+    free(code_lengths);
+}
+
+void decode_pipelined(NODE *huffman_tree_root, char *encoded_file, char *decoded_file)
+{
+    unsigned long k = 0;
+    int last_block = 0;          /* Whether the block marks the end of the file. */
+    FSM_STATE state = {0, 0, 0}; /* A code can continue in the next block. */
+    FSM *fsm = build_fsm_decoder(huffman_tree_root);
+    IO_PIPELINE pipeline;
+    pthread_t reader, writer;
+
+    start_pipeline(&pipeline, encoded_file, decoded_file, &reader, &writer);
+
+    /* Compute stage. Decodes the blocks in the order the reader thread filled them. */
+    for (k = 0;; k++)
+    {
+        BLOCK *block = &pipeline.slots[k % PIPELINE_SLOTS];
+
+        wait_for_count(&pipeline, &pipeline.read_count, k);
+
+        /*
+         * Each code is at least one bit, so there are at most as many characters as bits,
+         * plus up to 7 bits kept from the previous block.
+         */
+        if (block->input_size + 8 > block->output_capacity)
+        {
+            block->output_capacity = block->input_size + 8;
+            block->output = (char *)realloc(block->output, block->output_capacity);
+            if (block->output == NULL)
+            {
+                printf("Error: Unable to Allocate Memory using realloc\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        block->output_size = fsm_decode_text(fsm, &state, block->input, block->input_size,
+                                             block->output);
+        /* The bits that do not fill a byte are decoded at the end of the file. */
+        if (block->input_size == 0)
+        {
+            block->output_size = fsm_decode_flush(fsm, &state, block->output);
+        }
+
+        /* The block may be refilled as soon as it is handed over, so the end is checked first. */
+        last_block = (block->input_size == 0);
+        set_count(&pipeline, &pipeline.computed_count, k + 1);
+        if (last_block)
+        {
+            break;
+        }
+    }
+
+    stop_pipeline(&pipeline, reader, writer);
+    printf("Decoding done. Result in: \"%s\"\n", decoded_file);
+    free_fsm_decoder(fsm);
+}
+
+void start_pipeline(IO_PIPELINE *pipeline, char *in_file, char *out_file, pthread_t *reader,
+                    pthread_t *writer)
+{
+    int i = 0;
+
+    if ((pipeline->fp_read = fopen(in_file, "r")) == NULL)
+    {
+        printf("\"%s\" file cannot be opened\n", in_file);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((pipeline->fp_write = fopen(out_file, "w")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", out_file);
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < PIPELINE_SLOTS; i++)
+    {
+        pipeline->slots[i].input = (char *)malloc(PIPELINE_BLOCK_SIZE);
+        if (pipeline->slots[i].input == NULL)
+        {
+            printf("Error: Could not allocate memory using malloc\n");
+            exit(EXIT_FAILURE);
+        }
+        pipeline->slots[i].input_size = 0;
+        pipeline->slots[i].output = NULL;
+        pipeline->slots[i].output_size = 0;
+        pipeline->slots[i].output_capacity = 0;
+    }
+    pipeline->read_count = 0;
+    pipeline->computed_count = 0;
+    pipeline->written_count = 0;
+    pthread_mutex_init(&pipeline->lock, NULL);
+    pthread_cond_init(&pipeline->changed, NULL);
+
+    if (pthread_create(reader, NULL, pipeline_reader, pipeline) != 0 ||
+        pthread_create(writer, NULL, pipeline_writer, pipeline) != 0)
+    {
+        printf("Error: Could not create pipeline thread\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void stop_pipeline(IO_PIPELINE *pipeline, pthread_t reader, pthread_t writer)
+{
+    int i = 0;
+
+    pthread_join(reader, NULL);
+    pthread_join(writer, NULL);
+
+    for (i = 0; i < PIPELINE_SLOTS; i++)
+    {
+        free(pipeline->slots[i].input);
+        free(pipeline->slots[i].output);
+    }
+    pthread_mutex_destroy(&pipeline->lock);
+    pthread_cond_destroy(&pipeline->changed);
+    fclose(pipeline->fp_read);
+    if (fclose(pipeline->fp_write) != 0)
+    {
+        printf("Error: Unable to write the output file\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void wait_for_count(IO_PIPELINE *pipeline, unsigned long *counter, unsigned long value)
+{
+    pthread_mutex_lock(&pipeline->lock);
+    while (*counter <= value)
+    {
+        pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+void set_count(IO_PIPELINE *pipeline, unsigned long *counter, unsigned long value)
+{
+    /* Each counter has its own waiter, but only one condition, so every waiter is woken. */
+    pthread_mutex_lock(&pipeline->lock);
+    *counter = value;
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+void *pipeline_reader(void *pipeline)
+{
+    IO_PIPELINE *p = (IO_PIPELINE *)pipeline;
+    unsigned long k = 0;
+
+    for (k = 0;; k++)
+    {
+        BLOCK *block = &p->slots[k % PIPELINE_SLOTS];
+
+        /* The slot is free once the writer thread has written the block that was in it. */
+        if (k >= PIPELINE_SLOTS)
+        {
+            wait_for_count(p, &p->written_count, k - PIPELINE_SLOTS);
+        }
+
+        block->input_size = fread(block->input, 1, PIPELINE_BLOCK_SIZE, p->fp_read);
+        /* A read error is not the end of the file. */
+        if (block->input_size < PIPELINE_BLOCK_SIZE && ferror(p->fp_read))
+        {
+            printf("Error: Unable to read the input file\n");
+            exit(EXIT_FAILURE);
+        }
+
+        set_count(p, &p->read_count, k + 1);
+        /* An empty block tells the other stages that the file has ended. */
+        if (block->input_size == 0)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+void *pipeline_writer(void *pipeline)
+{
+    IO_PIPELINE *p = (IO_PIPELINE *)pipeline;
+    unsigned long k = 0;
+    int last_block = 0;
+
+    for (k = 0;; k++)
+    {
+        BLOCK *block = &p->slots[k % PIPELINE_SLOTS];
+
+        wait_for_count(p, &p->computed_count, k);
+
+        if (block->output_size > 0 &&
+            fwrite(block->output, 1, block->output_size, p->fp_write) != block->output_size)
+        {
+            printf("Error: Unable to write the output file\n");
+            exit(EXIT_FAILURE);
+        }
+
+        /* The block may be refilled as soon as it is handed over, so the end is checked first. */
+        last_block = (block->input_size == 0);
+        set_count(p, &p->written_count, k + 1);
+        if (last_block)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+#ifdef TEST_A
+int main(int argc, char **argv)
+{
+    char *prob_file = argv[1];
+    char *data_file = argv[2];
+    char *encoded_file = argv[3];
+    char *decoded_file = argv[4];
+
+    NODE *huffman_tree_root = generate_huffman_tree(prob_file);
+    char **huffman_table = generate_huffman_table(huffman_tree_root);
+    encode_pipelined(huffman_table, data_file, encoded_file);
+    decode_pipelined(huffman_tree_root, encoded_file, decoded_file);
+    free_huffman_tree(huffman_tree_root);
+    free_huffman_table(huffman_table);
+    return 0;
+}
+#endif
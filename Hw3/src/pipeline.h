@@ -0,0 +1,126 @@
+#ifndef PIPELINE
+#define PIPELINE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "huffman_tree.h"
+#include "encoder.h"
+#include "decoder.h"
+#include "fsm_decoder.h"
+
+/** @brief Number of blocks that can be in the pipeline at the same time. Power of two. */
+#define PIPELINE_SLOTS 8
+
+/** @brief Number of characters the reader thread reads into each block. */
+#define PIPELINE_BLOCK_SIZE 65536
+
+/** @brief A block of the pipeline.
+ *
+ *  The reader thread fills input, the compute stage turns it into output and the
+ *  writer thread writes output. A block with input_size 0 marks the end of the file.
+ */
+typedef struct {
+    char *input;
+    size_t input_size;
+    char *output;
+    size_t output_size;
+    size_t output_capacity;
+} BLOCK;
+
+/** @brief A read -> compute -> write pipeline.
+ *
+ *  The blocks form a ring. Each counter is the number of blocks a stage has finished and is
+ *  only changed by that stage, so a block belongs to one stage at a time. The counters are
+ *  protected by lock, and a stage waiting for another one sleeps on changed until a counter
+ *  moves. Block k is in slot k % PIPELINE_SLOTS.
+ */
+typedef struct {
+    BLOCK slots[PIPELINE_SLOTS];
+    unsigned long read_count;     /* Blocks filled by the reader thread. */
+    unsigned long computed_count; /* Blocks encoded or decoded by the compute stage. */
+    unsigned long written_count;  /* Blocks written by the writer thread. */
+    pthread_mutex_t lock;         /* Protects the counters. */
+    pthread_cond_t changed;       /* Signaled each time a counter moves. */
+    FILE *fp_read;
+    FILE *fp_write;
+} IO_PIPELINE;
+
+/** @brief Encodes a data file using the Huffman codes, overlapping I/O with encoding.
+ *
+ *   Same result as encode(), but reading, encoding and writing run at the same time on
+ *   different blocks of the file.
+ *
+ *   @param huffman_table the Huffman table to get the Huffman codes
+ *   @param data_file     the file to get the data to encode
+ *   @param encoded_file  the file name of the output file to save the encoded data in
+ *   @return void
+ */
+void encode_pipelined(char **huffman_table, char *data_file, char *encoded_file);
+
+/** @brief Decodes a data file using the Huffman binary tree, overlapping I/O with decoding.
+ *
+ *   Same result as decode(), but reading, decoding and writing run at the same time on
+ *   different blocks of the file.
+ *
+ *   @param huffman_tree_root the root of the Huffman binary tree
+ *   @param encoded_file      the file to get the encoded data to decode
+ *   @param decoded_file      the file name of the output file to save the decoded data in
+ *   @return void
+ */
+void decode_pipelined(NODE *huffman_tree_root, char *encoded_file, char *decoded_file);
+
+/** @brief Opens the files of the pipeline and starts the reader and writer threads.
+ *
+ *   @param pipeline the pipeline to start
+ *   @param in_file  the file the reader thread reads from
+ *   @param out_file the file the writer thread writes to
+ *   @param reader   the reader thread
+ *   @param writer   the writer thread
+ *   @return void
+ */
+void start_pipeline(IO_PIPELINE *pipeline, char *in_file, char *out_file, pthread_t *reader,
+                    pthread_t *writer);
+
+/** @brief Waits for the threads of the pipeline, closes its files and frees its blocks.
+ *
+ *   @param pipeline the pipeline to stop
+ *   @param reader   the reader thread
+ *   @param writer   the writer thread
+ *   @return void
+ */
+void stop_pipeline(IO_PIPELINE *pipeline, pthread_t reader, pthread_t writer);
+
+/** @brief Waits until a counter of the pipeline passes a value.
+ *
+ *   @param pipeline the pipeline
+ *   @param counter  the counter to wait for
+ *   @param value    the value the counter has to pass
+ *   @return void
+ */
+void wait_for_count(IO_PIPELINE *pipeline, unsigned long *counter, unsigned long value);
+
+/** @brief Moves a counter of the pipeline and wakes up the stages waiting for it.
+ *
+ *   @param pipeline the pipeline
+ *   @param counter  the counter of the stage
+ *   @param value    the new value of the counter
+ *   @return void
+ */
+void set_count(IO_PIPELINE *pipeline, unsigned long *counter, unsigned long value);
+
+/** @brief Reader thread. Fills the free blocks with the input file.
+ *
+ *   @param pipeline the IO_PIPELINE
+ *   @return NULL
+ */
+void *pipeline_reader(void *pipeline);
+
+/** @brief Writer thread. Writes the computed blocks in the output file.
+ *
+ *   @param pipeline the IO_PIPELINE
+ *   @return NULL
+ */
+void *pipeline_writer(void *pipeline);
+
+#endif
@@ -9,9 +9,10 @@ void generate_prob_table(char *sample_file, char *prob_file)
      * Array for the count of each character. Each index of the array corresponds to
      * the ASCII value of each character and each element to the count of each character.
     */
-    int *count_char = (int*) malloc(MAX_ASCII * sizeof(int)); 
+    unsigned long long *count_char = (unsigned long long *)malloc(MAX_ASCII *
+                                                                  sizeof(unsigned long long));
     float *prob_table = (float*) malloc(MAX_ASCII * sizeof(float));
-    int count_total = 0;  /* Counter for the sum of counts of all the characters. */ 
+    unsigned long long count_total = 0; /* Sum of the counts of all the characters. */
 
     if (count_char == NULL || prob_table == NULL)
     {
@@ -34,9 +35,12 @@ void generate_prob_table(char *sample_file, char *prob_file)
     free(prob_table);   
 }
 
-void count_characters(char *sample_file, int *count_char, int *count_total)
+void count_characters(char *sample_file, unsigned long long *count_char,
+                      unsigned long long *count_total)
 {    
-    char character = 0;
+    unsigned char buffer[BUFSIZ]; /* The file is read in blocks of BUFSIZ characters. */
+    size_t read_count = 0;
+    size_t i = 0;
     FILE *fp = NULL;
     if ((fp = fopen(sample_file, "r")) == NULL)
     {
@@ -44,22 +48,25 @@ void count_characters(char *sample_file, int *count_char, int *count_total)
         exit(EXIT_FAILURE);
     }
 
-    while ((character = fgetc(fp)) != EOF)
+    while ((read_count = fread(buffer, 1, sizeof(buffer), fp)) > 0)
     {        
-        /* Checks if a character is within the ASCII range specified by MAX_ASCII constant. */
-        if (character >= MAX_ASCII)
+        for (i = 0; i < read_count; i++)
         {
-            printf("File cannot have ASCII characters with value above 127\n");
-            exit(EXIT_FAILURE);
+            /* Checks if a character is within the ASCII range specified by MAX_ASCII constant. */
+            if (buffer[i] >= MAX_ASCII)
+            {
+                printf("File cannot have ASCII characters with value above 127\n");
+                exit(EXIT_FAILURE);
+            }
+            count_char[buffer[i]]++;
         }
-        
-        count_char[(int) character]++;
-        (*count_total)++;
+        (*count_total) += read_count;
     }
     fclose(fp);
 }
 
-void calc_probability(int *count_char, int count_total, float *prob_table)
+void calc_probability(unsigned long long *count_char, unsigned long long count_total,
+                      float *prob_table)
 {
     int i = 0;
     /* 
@@ -68,7 +75,7 @@ void calc_probability(int *count_char, int count_total, float *prob_table)
     */
     for (i = 0; i < MAX_ASCII; i++)
     {
-        prob_table[i] = ((float)count_char[i]) / ((float)count_total);
+        prob_table[i] = (float)((double)count_char[i] / (double)count_total);
     }
 }
 
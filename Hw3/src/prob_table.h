@@ -29,7 +29,8 @@ void generate_prob_table(char *sample_file, char *prob_file);
  *   @param count_total total characters in the file
  *   @return void
  */
-void count_characters(char *sample_file, int *count_char, int *count_total);
+void count_characters(char *sample_file, unsigned long long *count_char,
+                      unsigned long long *count_total);
 
 /** @brief Caclulates the probabilty of each character appearing.
  * 
@@ -40,7 +41,8 @@ void count_characters(char *sample_file, int *count_char, int *count_total);
  *   @param prob_table  the array to save the probability of each character
  *   @return void
  */
-void calc_probability(int *count_char, int count_total, float *prob_table);
+void calc_probability(unsigned long long *count_char, unsigned long long count_total,
+                      float *prob_table);
 
 /** @brief Saves the probability table in the specified file.
  *
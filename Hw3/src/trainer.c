@@ -0,0 +1,311 @@
+#define _XOPEN_SOURCE 700
+
+#include <string.h>
+#include <unistd.h>
+#include "trainer.h"
+
+void train_prob_table(char *snapshot_dir, char *prob_file, int add, char **files, int file_count)
+{
+    int i = 0, j = 0;
+    int wave_size = 0;            /* Number of files counted at the same time. */
+    char path[4096];
+    long long total = 0;
+    long long *aggregate = NULL;  /* The counts of the whole corpus. */
+    long long *snapshot = NULL;   /* The counts of one file. */
+    float *prob_table = NULL;
+    COUNT_JOB *jobs = NULL;
+    pthread_t *workers = NULL;
+
+    aggregate = (long long *)malloc(MAX_ASCII * sizeof(long long));
+    snapshot = (long long *)malloc(MAX_ASCII * sizeof(long long));
+    prob_table = (float *)malloc(MAX_ASCII * sizeof(float));
+    if (aggregate == NULL || snapshot == NULL || prob_table == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", snapshot_dir, AGGREGATE_SNAPSHOT);
+    read_snapshot(path, aggregate);
+
+    /* Every removed file is checked before the corpus is changed. */
+    for (i = 0; add == 0 && i < file_count; i++)
+    {
+        snapshot_path(snapshot_dir, files[i], path, sizeof(path));
+        if (access(path, F_OK) != 0)
+        {
+            printf("\"%s\" is not part of the corpus\n", files[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (add == 1)
+    {
+        jobs = (COUNT_JOB *)malloc(file_count * sizeof(COUNT_JOB));
+        workers = (pthread_t *)malloc(file_count * sizeof(pthread_t));
+        if (jobs == NULL || workers == NULL)
+        {
+            printf("Error: Could not allocate memory using malloc\n");
+            exit(EXIT_FAILURE);
+        }
+
+        /* Counts the files in waves of one worker per processor. */
+        wave_size = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if (wave_size < 1)
+        {
+            wave_size = 1;
+        }
+        for (i = 0; i < file_count; i += wave_size)
+        {
+            int wave_end = (i + wave_size < file_count) ? i + wave_size : file_count;
+
+            for (j = i; j < wave_end; j++)
+            {
+                jobs[j].sample_file = files[j];
+                if (pthread_create(&workers[j], NULL, count_worker, &jobs[j]) != 0)
+                {
+                    printf("Error: Could not create worker thread\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            for (j = i; j < wave_end; j++)
+            {
+                pthread_join(workers[j], NULL);
+            }
+        }
+    }
+
+    for (i = 0; i < file_count; i++)
+    {
+        snapshot_path(snapshot_dir, files[i], path, sizeof(path));
+
+        /* An old snapshot of the file is taken out of the aggregate before anything else. */
+        if (read_snapshot(path, snapshot) == 1)
+        {
+            for (j = 0; j < MAX_ASCII; j++)
+            {
+                aggregate[j] -= snapshot[j];
+            }
+        }
+
+        if (add == 1)
+        {
+            for (j = 0; j < MAX_ASCII; j++)
+            {
+                snapshot[j] = (long long)jobs[i].count_char[j];
+                aggregate[j] += snapshot[j];
+            }
+            write_snapshot(path, snapshot);
+            free(jobs[i].count_char);
+        }
+        else
+        {
+            remove(path);
+        }
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", snapshot_dir, AGGREGATE_SNAPSHOT);
+    write_snapshot(path, aggregate);
+
+    /* Probability of each character over the whole corpus. */
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        total += aggregate[i];
+    }
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        prob_table[i] = (total == 0) ? 0.0 : (float)((double)aggregate[i] / (double)total);
+    }
+    export_prob_table(prob_table, prob_file);
+
+    free(aggregate);
+    free(snapshot);
+    free(prob_table);
+    free(jobs);
+    free(workers);
+}
+
+void *count_worker(void *job)
+{
+    int i = 0;
+    COUNT_JOB *count_job = (COUNT_JOB *)job;
+
+    count_job->count_char = (unsigned long long *)malloc(MAX_ASCII *
+                                                         sizeof(unsigned long long));
+    if (count_job->count_char == NULL)
+    {
+        printf("Error: Could not allocate memory using malloc\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        count_job->count_char[i] = 0;
+    }
+    count_job->count_total = 0;
+
+    count_characters(count_job->sample_file, count_job->count_char, &count_job->count_total);
+    return NULL;
+}
+
+void snapshot_path(char *snapshot_dir, char *sample_file, char *path, size_t size)
+{
+    char *name = strrchr(sample_file, '/');
+    char *absolute = realpath(sample_file, NULL);
+    char directory[4096];
+    char full_path[8192];
+    unsigned long long hash = 14695981039346656037ULL; /* FNV-1a offset basis. */
+    unsigned char *c = NULL;
+
+    name = (name == NULL) ? sample_file : name + 1;
+
+    /* A removed file may not exist anymore, then its directory gives the absolute path. */
+    if (absolute == NULL)
+    {
+        char *real_directory = NULL;
+
+        if (name == sample_file)
+        {
+            real_directory = realpath(".", NULL);
+        }
+        else
+        {
+            snprintf(directory, sizeof(directory), "%.*s", (int)(name - sample_file), sample_file);
+            real_directory = realpath(directory, NULL);
+        }
+
+        if (real_directory != NULL)
+        {
+            snprintf(full_path, sizeof(full_path), "%s/%s", real_directory, name);
+        }
+        else if (sample_file[0] != '/' && getcwd(directory, sizeof(directory)) != NULL)
+        {
+            snprintf(full_path, sizeof(full_path), "%s/%s", directory, sample_file);
+        }
+        else
+        {
+            snprintf(full_path, sizeof(full_path), "%s", sample_file);
+        }
+        free(real_directory);
+        normalize_path(full_path);
+    }
+    for (c = (unsigned char *)((absolute == NULL) ? full_path : absolute); *c != '\0'; c++)
+    {
+        hash = (hash ^ *c) * 1099511628211ULL;
+    }
+    free(absolute);
+
+    snprintf(path, size, "%s/%s.%016llx.cnt", snapshot_dir, name, hash);
+}
+
+void normalize_path(char *path)
+{
+    char *read = path, *write = path;
+
+    /* The path is rebuilt in place, one component at a time. */
+    while (*read != '\0')
+    {
+        char *end = strchr(read, '/');
+        size_t length = (end == NULL) ? strlen(read) : (size_t)(end - read);
+
+        if (length == 2 && read[0] == '.' && read[1] == '.')
+        {
+            /* Goes back to the last '/', but never before the root. */
+            while (write > path && *(write - 1) != '/')
+            {
+                write--;
+            }
+            if (write > path + 1)
+            {
+                write--;
+            }
+        }
+        else if (length > 0 && !(length == 1 && read[0] == '.'))
+        {
+            if (write == path || *(write - 1) != '/')
+            {
+                *write++ = '/';
+            }
+            memmove(write, read, length);
+            write += length;
+        }
+        read += length;
+        if (*read == '/')
+        {
+            read++;
+        }
+    }
+    if (write == path)
+    {
+        *write++ = '/';
+    }
+    *write = '\0';
+}
+
+int read_snapshot(char *path, long long *counts)
+{
+    int i = 0;
+    FILE *fp = NULL;
+
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        counts[i] = 0;
+    }
+
+    if ((fp = fopen(path, "r")) == NULL)
+    {
+        return 0;
+    }
+
+    /* One count per line, in the order of the ASCII table. */
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        if (fscanf(fp, "%lld", &counts[i]) != 1)
+        {
+            printf("Snapshot \"%s\" is corrupted\n", path);
+            exit(EXIT_FAILURE);
+        }
+    }
+    fclose(fp);
+    return 1;
+}
+
+void write_snapshot(char *path, long long *counts)
+{
+    int i = 0;
+    int written = 1;
+    char temporary[4096];
+    FILE *fp = NULL;
+
+    /* The snapshot is written next to the old one, which it replaces only once complete. */
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+    if ((fp = fopen(temporary, "w")) == NULL)
+    {
+        printf("Error: Unable to create \"%s\" output file\n", temporary);
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < MAX_ASCII; i++)
+    {
+        if (fprintf(fp, "%lld\n", counts[i]) < 0)
+        {
+            written = 0;
+        }
+    }
+    if (fclose(fp) != 0 || written == 0 || rename(temporary, path) != 0)
+    {
+        printf("Error: Unable to write \"%s\" output file\n", path);
+        remove(temporary);
+        exit(EXIT_FAILURE);
+    }
+}
+
+#ifdef TEST_T
+int main(int argc, char **argv)
+{
+    char *snapshot_dir = argv[1];
+    char *prob_file = argv[2];
+
+    train_prob_table(snapshot_dir, prob_file, 1, argv + 3, argc - 3);
+    return 0;
+}
+#endif
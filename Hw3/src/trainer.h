@@ -0,0 +1,94 @@
+#ifndef TRAINER
+#define TRAINER
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "prob_table.h"
+
+/** @brief Name of the snapshot that holds the sum of all the other snapshots. */
+#define AGGREGATE_SNAPSHOT "aggregate.cnt"
+
+/** @brief A file of the corpus whose characters a worker counts.
+ *
+ *  Each worker thread counts one file and saves the counts in its own COUNT_JOB,
+ *  so the workers share nothing.
+ */
+typedef struct {
+    char *sample_file; /* The file to count. */
+    unsigned long long *count_char;  /* The count of each character in the file. */
+    unsigned long long count_total;  /* The total amount of characters in the file. */
+} COUNT_JOB;
+
+/** @brief Adds files to the training corpus or removes them from it.
+ *
+ *   Added files are counted in parallel and the counts of each one are saved as a
+ *   snapshot named after the file in snapshot_dir. The sum of all the snapshots is kept
+ *   in AGGREGATE_SNAPSHOT, which is updated by adding or subtracting the snapshots of the
+ *   changed files only. Adding a file that already has a snapshot replaces it. Removed files
+ *   only need their snapshot, so they may already be deleted. The program is terminated
+ *   before anything is changed if a removed file has no snapshot. The probability table of
+ *   the whole corpus is then saved in prob_file.
+ *
+ *   @param snapshot_dir the directory with the snapshots
+ *   @param prob_file    the file to write the probability table to
+ *   @param add          1 to add the files or 0 to remove them
+ *   @param files        the files to add or remove
+ *   @param file_count   the number of files
+ *   @return void
+ */
+void train_prob_table(char *snapshot_dir, char *prob_file, int add, char **files, int file_count);
+
+/** @brief Worker thread of train_prob_table().
+ *
+ *   @param job the COUNT_JOB of the file to count
+ *   @return NULL
+ */
+void *count_worker(void *job);
+
+/** @brief Builds the path of the snapshot of a file.
+ *
+ *   The snapshot has the name of the file, without its directories, then a 64-bit FNV-1a
+ *   hash of its absolute path in hexadecimal and the ".cnt" extension, so files with the same
+ *   name in different directories, or named like AGGREGATE_SNAPSHOT, get their own snapshot.
+ *   The absolute path of a file that no longer exists is the one of its directory followed
+ *   by its name, or, without the directory either, its path from the current directory
+ *   after normalize_path().
+ *
+ *   @param snapshot_dir the directory with the snapshots
+ *   @param sample_file  the file of the corpus
+ *   @param path         the string to save the path in
+ *   @param size         the size of path
+ *   @return void
+ */
+void snapshot_path(char *snapshot_dir, char *sample_file, char *path, size_t size);
+
+/** @brief Normalizes an absolute path without looking at the files.
+ *
+ *   Repeated '/' and "." are dropped and ".." removes the directory before it.
+ *
+ *   @param path the path, changed in place
+ *   @return void
+ */
+void normalize_path(char *path);
+
+/** @brief Reads the character counts of a snapshot.
+ *
+ *   @param path   the snapshot to read
+ *   @param counts array to save the count of each character
+ *   @return 1 if the snapshot exists or 0 otherwise, in which case the counts are 0
+ */
+int read_snapshot(char *path, long long *counts);
+
+/** @brief Saves the character counts in a snapshot.
+ *
+ *   The counts are written to a temporary file that is then renamed to the snapshot, so the
+ *   old snapshot stays whole if the writing fails. The program is terminated if it does.
+ *
+ *   @param path   the snapshot to write
+ *   @param counts the count of each character
+ *   @return void
+ */
+void write_snapshot(char *path, long long *counts);
+
+#endif